@@ -30,11 +30,11 @@ void init_array (int m,
 {
   int i, j;
 
-  *float_n = (DATA_TYPE)N;
+  *float_n = (DATA_TYPE)n;
 
-  for (i = 0; i < N; i++)
-    for (j = 0; j < M; j++)
-      data[i][j] = (DATA_TYPE)(i*j)/M + i;
+  for (i = 0; i < n; i++)
+    for (j = 0; j < m; j++)
+      data[i][j] = (DATA_TYPE)(i*j)/m + i;
 
 }
 
@@ -127,8 +127,8 @@ void kernel_correlation(int m, int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
-  int m = M;
+  int n = POLYBENCH_SIZE(N);
+  int m = POLYBENCH_SIZE(M);
 
   /* Variable declaration/allocation. */
   DATA_TYPE float_n;
@@ -137,6 +137,9 @@ int main(int argc, char** argv)
   POLYBENCH_1D_ARRAY_DECL(mean,DATA_TYPE,M,m);
   POLYBENCH_1D_ARRAY_DECL(stddev,DATA_TYPE,M,m);
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (m, n, &float_n, POLYBENCH_ARRAY(data));
 
@@ -152,6 +155,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
@@ -31,9 +31,9 @@ void init_array (int m, int n,
 
   *float_n = (DATA_TYPE)n;
 
-  for (i = 0; i < N; i++)
-    for (j = 0; j < M; j++)
-      data[i][j] = ((DATA_TYPE) i*j) / M;
+  for (i = 0; i < n; i++)
+    for (j = 0; j < m; j++)
+      data[i][j] = ((DATA_TYPE) i*j) / m;
 }
 
 
@@ -99,8 +99,8 @@ void kernel_covariance(int m, int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
-  int m = M;
+  int n = POLYBENCH_SIZE(N);
+  int m = POLYBENCH_SIZE(M);
 
   /* Variable declaration/allocation. */
   DATA_TYPE float_n;
@@ -109,6 +109,9 @@ int main(int argc, char** argv)
   POLYBENCH_1D_ARRAY_DECL(mean,DATA_TYPE,M,m);
 
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (m, n, &float_n, POLYBENCH_ARRAY(data));
 
@@ -123,6 +126,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
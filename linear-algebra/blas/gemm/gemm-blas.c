@@ -56,6 +56,10 @@ void print_array(int ni, int nj,
 {
   int i, j;
 
+#ifdef POLYBENCH_CHECKSUM
+  POLYBENCH_CHECKSUM_2D("C", C, ni, nj);
+  return;
+#endif
   POLYBENCH_DUMP_START;
   POLYBENCH_DUMP_BEGIN("C");
   for (i = 0; i < ni; i++)
@@ -87,18 +91,42 @@ void kernel_gemm(int ni, int nj, int nk,
 //B is NKxNJ
 //C is NIxNJ
 #pragma scop
-    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, ni, nj, nk, alpha, (const double *) A, nk, (const double *) B, nj, beta, (double *) C, nj);
+    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, ni, nj, nk, alpha, (const double *) A, POLYBENCH_LEADING_DIM(A), (const double *) B, POLYBENCH_LEADING_DIM(B), beta, (double *) C, POLYBENCH_LEADING_DIM(C));
 #pragma endscop
 
 }
 
+#ifdef POLYBENCH_VERIFY
+/* Reference implementation of gemm.c, run on a copy of the inputs to
+   verify the results. */
+static
+void kernel_gemm_reference(int ni, int nj, int nk,
+			   DATA_TYPE alpha,
+			   DATA_TYPE beta,
+			   DATA_TYPE POLYBENCH_2D(C,NI,NJ,ni,nj),
+			   DATA_TYPE POLYBENCH_2D(A,NI,NK,ni,nk),
+			   DATA_TYPE POLYBENCH_2D(B,NK,NJ,nk,nj))
+{
+  int i, j, k;
+
+  for (i = 0; i < _PB_NI; i++) {
+    for (j = 0; j < _PB_NJ; j++)
+	C[i][j] *= beta;
+    for (k = 0; k < _PB_NK; k++) {
+       for (j = 0; j < _PB_NJ; j++)
+	  C[i][j] += alpha * A[i][k] * B[k][j];
+    }
+  }
+}
+#endif
+
 
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int ni = NI;
-  int nj = NJ;
-  int nk = NK;
+  int ni = POLYBENCH_SIZE(NI);
+  int nj = POLYBENCH_SIZE(NJ);
+  int nk = POLYBENCH_SIZE(NK);
 
   /* Variable declaration/allocation. */
   DATA_TYPE alpha;
@@ -106,12 +134,33 @@ int main(int argc, char** argv)
   POLYBENCH_2D_ARRAY_DECL(C,DATA_TYPE,NI,NJ,ni,nj);
   POLYBENCH_2D_ARRAY_DECL(A,DATA_TYPE,NI,NK,ni,nk);
   POLYBENCH_2D_ARRAY_DECL(B,DATA_TYPE,NK,NJ,nk,nj);
-
-  /* Initialize array(s). */
-  init_array (ni, nj, nk, &alpha, &beta,
-	      POLYBENCH_ARRAY(C),
-	      POLYBENCH_ARRAY(A),
-	      POLYBENCH_ARRAY(B));
+#ifdef POLYBENCH_VERIFY
+  /* Copy of the input C of the last run, for the reference. */
+  POLYBENCH_2D_ARRAY_DECL(C_ref,DATA_TYPE,NI,NJ,ni,nj);
+#endif
+
+  /* Data kept by the dataset cache, if enabled. */
+  polybench_dataset_scalar (alpha);
+  polybench_dataset_scalar (beta);
+  polybench_dataset_array (C);
+  polybench_dataset_array (A);
+  polybench_dataset_array (B);
+
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
+  /* Initialize array(s), unless the dataset cache holds them. */
+  if (! polybench_dataset_load ())
+    {
+      init_array (ni, nj, nk, &alpha, &beta,
+		  POLYBENCH_ARRAY(C),
+		  POLYBENCH_ARRAY(A),
+		  POLYBENCH_ARRAY(B));
+      polybench_dataset_store ();
+    }
+#ifdef POLYBENCH_VERIFY
+  POLYBENCH_COPY_ARRAY(C_ref, C);
+#endif
 
   /* Start timer. */
   polybench_start_instruments;
@@ -125,16 +174,31 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
      by the function call in argument. */
   polybench_prevent_dce(print_array(ni, nj,  POLYBENCH_ARRAY(C)));
 
+#ifdef POLYBENCH_VERIFY
+  /* Compare with the reference implementation run on the same inputs. */
+  kernel_gemm_reference (ni, nj, nk,
+			 alpha, beta,
+			 POLYBENCH_ARRAY(C_ref),
+			 POLYBENCH_ARRAY(A),
+			 POLYBENCH_ARRAY(B));
+  POLYBENCH_VERIFY_2D("C", POLYBENCH_ARRAY(C), POLYBENCH_ARRAY(C_ref),
+		      ni, nj);
+#endif
+
   /* Be clean. */
   POLYBENCH_FREE_ARRAY(C);
   POLYBENCH_FREE_ARRAY(A);
   POLYBENCH_FREE_ARRAY(B);
+#ifdef POLYBENCH_VERIFY
+  POLYBENCH_FREE_ARRAY(C_ref);
+#endif
 
-  return 0;
+  return polybench_verify_status ();
 }
@@ -212,17 +212,17 @@ int rank, size;
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
     
-    if (size > NI) {
-      printf("Hola Hola! size must be <= NI. was %d > %d  Exiting", size, NI);
+    if (size > POLYBENCH_SIZE(NI)) {
+      printf("Hola Hola! size must be <= NI. was %d > %d  Exiting", size, POLYBENCH_SIZE(NI));
       MPI_Finalize();
   
       return 1;
     }
 
   /* Retrieve problem size. */
-  int ni = NI;
-  int nj = NJ;
-  int nk = NK;
+  int ni = POLYBENCH_SIZE(NI);
+  int nj = POLYBENCH_SIZE(NJ);
+  int nk = POLYBENCH_SIZE(NK);
 
   /* Variable declaration/allocation. */
   int startI, endI;
@@ -245,6 +245,9 @@ int rank, size;
   A=allocate_array(iSizeToAllocate, nk);
   B=allocate_array(nk, nj);
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   if (rank == 0) {
     init_array (ni, nj, nk,
@@ -274,6 +277,7 @@ int rank, size;
     // stop time only when all workers are done
     polybench_stop_instruments;
   }
+  polybench_repeat_end;
 
   //polybench_print_instruments;
   if (rank == 0) {
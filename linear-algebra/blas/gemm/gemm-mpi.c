@@ -340,6 +340,30 @@ MPI_Gatherv(*C, (nrOfElements + 1) * nj, MPI_DOUBLE,
 
 }
 
+#ifdef POLYBENCH_VERIFY
+/* Reference implementation of gemm.c, run by rank 0 on a copy of the
+   inputs to verify the results. */
+static
+void kernel_gemm_reference(int ni, int nj, int nk,
+			   DATA_TYPE alpha,
+			   DATA_TYPE beta,
+			   double **C,
+			   double **A,
+			   double **B)
+{
+  int i, j, k;
+
+  for (i = 0; i < _PB_NI; i++) {
+    for (j = 0; j < _PB_NJ; j++)
+	C[i][j] *= beta;
+    for (k = 0; k < _PB_NK; k++) {
+       for (j = 0; j < _PB_NJ; j++)
+	  C[i][j] += alpha * A[i][k] * B[k][j];
+    }
+  }
+}
+#endif
+
 int calcISize(int startI, int endI) {
   return endI - startI + 1;
 }
@@ -355,8 +379,8 @@ int rank, size;
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
     
-    if (size > NI) {
-      printf("Hola Hola! size must be <= NI. was %d > %d  Exiting", size, NI);
+    if (size > POLYBENCH_SIZE(NI)) {
+      printf("Hola Hola! size must be <= NI. was %d > %d  Exiting", size, POLYBENCH_SIZE(NI));
       MPI_Finalize();
   
       return 1;
@@ -365,9 +389,9 @@ int rank, size;
 
 
   /* Retrieve problem size. */
-  int ni = NI;
-  int nj = NJ;
-  int nk = NK;
+  int ni = POLYBENCH_SIZE(NI);
+  int nj = POLYBENCH_SIZE(NJ);
+  int nk = POLYBENCH_SIZE(NK);
 
   int startI, endI;
   getStartEnd(ni, rank, size, &startI, &endI);
@@ -388,13 +412,28 @@ int rank, size;
   C=allocate_array(iSizeToAllocate, nj);
   A=allocate_array(iSizeToAllocate, nk);
   B=allocate_array(nk, nj);
+#ifdef POLYBENCH_VERIFY
+  /* Copy of the inputs of the last run, for the reference. */
+  double **C_ref = NULL, **A_ref = NULL;
+  if (rank == 0) {
+    C_ref = allocate_array(ni, nj);
+    A_ref = allocate_array(ni, nk);
+  }
+#endif
   
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   if (rank == 0) {
     init_array (ni, nj, nk,
 	      C,
 	      A,
 	      B);
+#ifdef POLYBENCH_VERIFY
+    memcpy (C_ref[0], C[0], ni * nj * sizeof(double));
+    memcpy (A_ref[0], A[0], ni * nk * sizeof(double));
+#endif
     
   }
 
@@ -416,12 +455,24 @@ int rank, size;
     // stop time only when all workers are done
     polybench_stop_instruments;
   }
+  polybench_repeat_end;
 
   
 
   if (rank == 0) {
     polybench_print_instruments;
     polybench_prevent_dce(print_array(ni, nj, C));
+
+#ifdef POLYBENCH_VERIFY
+    /* Compare with the reference implementation run on the same
+       inputs. */
+    kernel_gemm_reference (ni, nj, nk, alpha, beta, C_ref, A_ref, B);
+    polybench_verify_array ("C", C[0], C_ref[0], ni, nj, nj, nj,
+			    POLYBENCH_STRINGIFY(DATA_TYPE),
+			    POLYBENCH_VERIFY_TOLERANCE);
+    deallocate_array(C_ref, ni);
+    deallocate_array(A_ref, ni);
+#endif
   }
 
   /* Be clean. */
@@ -430,5 +481,5 @@ int rank, size;
   deallocate_array(B, nk);
 
   MPI_Finalize();
-  return 0;
+  return polybench_verify_status ();
 }
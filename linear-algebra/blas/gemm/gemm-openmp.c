@@ -15,6 +15,11 @@
 #include <math.h>
 #include <immintrin.h>
 
+/* The kernel uses aligned AVX loads and stores on the rows of C. */
+#ifndef POLYBENCH_ROW_ALIGNMENT
+# define POLYBENCH_ROW_ALIGNMENT 32
+#endif
+
 /* Include polybench common header. */
 #include <polybench.h>
 
@@ -35,12 +40,15 @@ void init_array(int ni, int nj, int nk,
 
   *alpha = 1.5;
   *beta = 1.2;
+  polybench_parallel_init (j)
   for (i = 0; i < ni; i++)
     for (j = 0; j < nj; j++)
       C[i][j] = (DATA_TYPE) ((i*j+1) % ni) / ni;
+  polybench_parallel_init (j)
   for (i = 0; i < ni; i++)
     for (j = 0; j < nk; j++)
       A[i][j] = (DATA_TYPE) (i*(j+1) % nk) / nk;
+  polybench_parallel_init (j)
   for (i = 0; i < nk; i++)
     for (j = 0; j < nj; j++)
       B[i][j] = (DATA_TYPE) (i*(j+2) % nj) / nj;
@@ -55,6 +63,10 @@ void print_array(int ni, int nj,
 {
   int i, j;
 
+#ifdef POLYBENCH_CHECKSUM
+  POLYBENCH_CHECKSUM_2D("C", C, ni, nj);
+  return;
+#endif
   POLYBENCH_DUMP_START;
   POLYBENCH_DUMP_BEGIN("C");
   for (i = 0; i < ni; i++)
@@ -70,6 +82,7 @@ void print_array(int ni, int nj,
 #define BJ 40
 #define BK 12
 
+#ifndef POLYBENCH_TILED_LAYOUT
 /* Main computational kernel. The whole function will be timed,
    including the call and return. */
 static
@@ -89,7 +102,7 @@ void kernel_gemm(int ni, int nj, int nk,
     int j;
     for (j = 0; j < _PB_NJ - BJ + 1; j += BJ) {
       for (int u = i; u < i + BI; u++) {
-        for (int v = j; v < j + BJ; v++) {
+        for (int v = j; v < j + BJ; v += 4) {
           //C[i][j] *= beta;
             __m256d vc = _mm256_load_pd(&C[u][v]);
             __m256d vMultiResult = _mm256_mul_pd(vbeta, vc);                          
@@ -131,15 +144,15 @@ void kernel_gemm(int ni, int nj, int nk,
               ab13 = _mm256_fmadd_pd(a3, b1, ab13);
             }
 
-            __m256d c00 = _mm256_loadu_pd(&C[u + 0][v + 0]);
-            __m256d c01 = _mm256_loadu_pd(&C[u + 1][v + 0]);
-            __m256d c02 = _mm256_loadu_pd(&C[u + 2][v + 0]);
-            __m256d c03 = _mm256_loadu_pd(&C[u + 3][v + 0]);
+            __m256d c00 = _mm256_load_pd(&C[u + 0][v + 0]);
+            __m256d c01 = _mm256_load_pd(&C[u + 1][v + 0]);
+            __m256d c02 = _mm256_load_pd(&C[u + 2][v + 0]);
+            __m256d c03 = _mm256_load_pd(&C[u + 3][v + 0]);
 
-            __m256d c10 = _mm256_loadu_pd(&C[u + 0][v + 4]);
-            __m256d c11 = _mm256_loadu_pd(&C[u + 1][v + 4]);
-            __m256d c12 = _mm256_loadu_pd(&C[u + 2][v + 4]);
-            __m256d c13 = _mm256_loadu_pd(&C[u + 3][v + 4]);
+            __m256d c10 = _mm256_load_pd(&C[u + 0][v + 4]);
+            __m256d c11 = _mm256_load_pd(&C[u + 1][v + 4]);
+            __m256d c12 = _mm256_load_pd(&C[u + 2][v + 4]);
+            __m256d c13 = _mm256_load_pd(&C[u + 3][v + 4]);
 
             c00 = _mm256_fmadd_pd(valpha, ab00, c00);
             c01 = _mm256_fmadd_pd(valpha, ab01, c01);
@@ -151,15 +164,15 @@ void kernel_gemm(int ni, int nj, int nk,
             c12 = _mm256_fmadd_pd(valpha, ab12, c12);
             c13 = _mm256_fmadd_pd(valpha, ab13, c13);
 
-            _mm256_storeu_pd(&C[u + 0][v + 0], c00);
-            _mm256_storeu_pd(&C[u + 1][v + 0], c01);
-            _mm256_storeu_pd(&C[u + 2][v + 0], c02);
-            _mm256_storeu_pd(&C[u + 3][v + 0], c03);
+            _mm256_store_pd(&C[u + 0][v + 0], c00);
+            _mm256_store_pd(&C[u + 1][v + 0], c01);
+            _mm256_store_pd(&C[u + 2][v + 0], c02);
+            _mm256_store_pd(&C[u + 3][v + 0], c03);
 
-            _mm256_storeu_pd(&C[u + 0][v + 4], c10);
-            _mm256_storeu_pd(&C[u + 1][v + 4], c11);
-            _mm256_storeu_pd(&C[u + 2][v + 4], c12);
-            _mm256_storeu_pd(&C[u + 3][v + 4], c13);
+            _mm256_store_pd(&C[u + 0][v + 4], c10);
+            _mm256_store_pd(&C[u + 1][v + 4], c11);
+            _mm256_store_pd(&C[u + 2][v + 4], c12);
+            _mm256_store_pd(&C[u + 3][v + 4], c13);
           }
         }
       }
@@ -200,6 +213,93 @@ void kernel_gemm(int ni, int nj, int nk,
 #pragma endscop
 
 }
+#endif
+
+#ifdef POLYBENCH_TILED_LAYOUT
+# if POLYBENCH_TILE_SIZE % 8 != 0
+#  error "The tiled gemm kernel requires POLYBENCH_TILE_SIZE to be a multiple of 8"
+# endif
+/* Same computation on tile-major copies of the arrays. Each tile is a
+   contiguous, aligned T x T block, and the edge tiles are padded with
+   zeros, so that there is no remainder loop: the padding rows and
+   columns of C are computed and dropped by POLYBENCH_FROM_TILED. */
+static
+void kernel_gemm_tiled(int ni, int nj, int nk,
+		       DATA_TYPE alpha,
+		       DATA_TYPE beta,
+		       DATA_TYPE *C,
+		       DATA_TYPE *A,
+		       DATA_TYPE *B)
+{
+  const int T = POLYBENCH_TILE_SIZE;
+  __m256d valpha = _mm256_set1_pd(alpha);
+  __m256d vbeta = _mm256_set1_pd(beta);
+
+  #pragma omp parallel for
+  for (int i = 0; i < _PB_NI; i += T) {
+    for (int j = 0; j < _PB_NJ; j += T) {
+      DATA_TYPE *c = POLYBENCH_TILE_PTR(C, i, j, nj);
+
+      for (int v = 0; v < T * T; v += 4)
+        _mm256_store_pd(&c[v], _mm256_mul_pd(vbeta, _mm256_load_pd(&c[v])));
+
+      for (int k = 0; k < _PB_NK; k += T) {
+        DATA_TYPE *a = POLYBENCH_TILE_PTR(A, i, k, nk);
+        DATA_TYPE *b = POLYBENCH_TILE_PTR(B, k, j, nj);
+
+        for (int u = 0; u < T; u += 4) {
+          for (int v = 0; v < T; v += 8) {
+            __m256d ab00 = _mm256_set1_pd(0.0);
+            __m256d ab01 = _mm256_set1_pd(0.0);
+            __m256d ab02 = _mm256_set1_pd(0.0);
+            __m256d ab03 = _mm256_set1_pd(0.0);
+
+            __m256d ab10 = _mm256_set1_pd(0.0);
+            __m256d ab11 = _mm256_set1_pd(0.0);
+            __m256d ab12 = _mm256_set1_pd(0.0);
+            __m256d ab13 = _mm256_set1_pd(0.0);
+
+            for (int w = 0; w < T; w++) {
+              __m256d a0 = _mm256_set1_pd(a[(u + 0) * T + w]);
+              __m256d a1 = _mm256_set1_pd(a[(u + 1) * T + w]);
+              __m256d a2 = _mm256_set1_pd(a[(u + 2) * T + w]);
+              __m256d a3 = _mm256_set1_pd(a[(u + 3) * T + w]);
+
+              __m256d b0 = _mm256_load_pd(&b[w * T + v + 0]);
+              __m256d b1 = _mm256_load_pd(&b[w * T + v + 4]);
+
+              ab00 = _mm256_fmadd_pd(a0, b0, ab00);
+              ab01 = _mm256_fmadd_pd(a1, b0, ab01);
+              ab02 = _mm256_fmadd_pd(a2, b0, ab02);
+              ab03 = _mm256_fmadd_pd(a3, b0, ab03);
+
+              ab10 = _mm256_fmadd_pd(a0, b1, ab10);
+              ab11 = _mm256_fmadd_pd(a1, b1, ab11);
+              ab12 = _mm256_fmadd_pd(a2, b1, ab12);
+              ab13 = _mm256_fmadd_pd(a3, b1, ab13);
+            }
+
+            DATA_TYPE *c0 = &c[(u + 0) * T + v];
+            DATA_TYPE *c1 = &c[(u + 1) * T + v];
+            DATA_TYPE *c2 = &c[(u + 2) * T + v];
+            DATA_TYPE *c3 = &c[(u + 3) * T + v];
+
+            _mm256_store_pd(c0, _mm256_fmadd_pd(valpha, ab00, _mm256_load_pd(c0)));
+            _mm256_store_pd(c1, _mm256_fmadd_pd(valpha, ab01, _mm256_load_pd(c1)));
+            _mm256_store_pd(c2, _mm256_fmadd_pd(valpha, ab02, _mm256_load_pd(c2)));
+            _mm256_store_pd(c3, _mm256_fmadd_pd(valpha, ab03, _mm256_load_pd(c3)));
+
+            _mm256_store_pd(c0 + 4, _mm256_fmadd_pd(valpha, ab10, _mm256_load_pd(c0 + 4)));
+            _mm256_store_pd(c1 + 4, _mm256_fmadd_pd(valpha, ab11, _mm256_load_pd(c1 + 4)));
+            _mm256_store_pd(c2 + 4, _mm256_fmadd_pd(valpha, ab12, _mm256_load_pd(c2 + 4)));
+            _mm256_store_pd(c3 + 4, _mm256_fmadd_pd(valpha, ab13, _mm256_load_pd(c3 + 4)));
+          }
+        }
+      }
+    }
+  }
+}
+#endif
 
 static
 void kernel_gemm_original(int ni, int nj, int nk,
@@ -234,9 +334,9 @@ void kernel_gemm_original(int ni, int nj, int nk,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int ni = NI;
-  int nj = NJ;
-  int nk = NK;
+  int ni = POLYBENCH_SIZE(NI);
+  int nj = POLYBENCH_SIZE(NJ);
+  int nk = POLYBENCH_SIZE(NK);
 
   // polybench_program_total_flops = (double) ni * (double) nj * (2 * (double) nk - 1);
 
@@ -246,35 +346,95 @@ int main(int argc, char** argv)
   POLYBENCH_2D_ARRAY_DECL(C,DATA_TYPE,NI,NJ,ni,nj);
   POLYBENCH_2D_ARRAY_DECL(A,DATA_TYPE,NI,NK,ni,nk);
   POLYBENCH_2D_ARRAY_DECL(B,DATA_TYPE,NK,NJ,nk,nj);
+#ifdef POLYBENCH_VERIFY
+  /* Copy of the input C of the last run, for the reference. */
+  POLYBENCH_2D_ARRAY_DECL(C_ref,DATA_TYPE,NI,NJ,ni,nj);
+#endif
+#ifdef POLYBENCH_TILED_LAYOUT
+  POLYBENCH_TILED_ARRAY_DECL(tC,DATA_TYPE,ni,nj);
+  POLYBENCH_TILED_ARRAY_DECL(tA,DATA_TYPE,ni,nk);
+  POLYBENCH_TILED_ARRAY_DECL(tB,DATA_TYPE,nk,nj);
+#endif
+
+  /* Data kept by the dataset cache, if enabled. */
+  polybench_dataset_scalar (alpha);
+  polybench_dataset_scalar (beta);
+  polybench_dataset_array (C);
+  polybench_dataset_array (A);
+  polybench_dataset_array (B);
+
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
+  /* Initialize array(s), unless the dataset cache holds them. */
+  if (! polybench_dataset_load ())
+    {
+      init_array (ni, nj, nk, &alpha, &beta,
+		  POLYBENCH_ARRAY(C),
+		  POLYBENCH_ARRAY(A),
+		  POLYBENCH_ARRAY(B));
+      polybench_dataset_store ();
+    }
+#ifdef POLYBENCH_VERIFY
+  POLYBENCH_COPY_ARRAY(C_ref, C);
+#endif
 
-  /* Initialize array(s). */
-  init_array (ni, nj, nk, &alpha, &beta,
-	      POLYBENCH_ARRAY(C),
-	      POLYBENCH_ARRAY(A),
-	      POLYBENCH_ARRAY(B));
+#ifdef POLYBENCH_TILED_LAYOUT
+  /* Convert to the tile-major layout, out of the timed region. */
+  POLYBENCH_TO_TILED(tC, POLYBENCH_ARRAY(C), ni, nj);
+  POLYBENCH_TO_TILED(tA, POLYBENCH_ARRAY(A), ni, nk);
+  POLYBENCH_TO_TILED(tB, POLYBENCH_ARRAY(B), nk, nj);
+#endif
 
   /* Start timer. */
   polybench_start_instruments;
 
   /* Run kernel. */
+#ifdef POLYBENCH_TILED_LAYOUT
+  kernel_gemm_tiled (ni, nj, nk, alpha, beta, tC, tA, tB);
+#else
   kernel_gemm (ni, nj, nk,
 	       alpha, beta,
 	       POLYBENCH_ARRAY(C),
 	       POLYBENCH_ARRAY(A),
 	       POLYBENCH_ARRAY(B));
+#endif
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+#ifdef POLYBENCH_TILED_LAYOUT
+  POLYBENCH_FROM_TILED(POLYBENCH_ARRAY(C), tC, ni, nj);
+#endif
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
      by the function call in argument. */
   polybench_prevent_dce(print_array(ni, nj,  POLYBENCH_ARRAY(C)));
 
+#ifdef POLYBENCH_VERIFY
+  /* Compare with the reference implementation run on the same inputs. */
+  kernel_gemm_original (ni, nj, nk,
+			alpha, beta,
+			POLYBENCH_ARRAY(C_ref),
+			POLYBENCH_ARRAY(A),
+			POLYBENCH_ARRAY(B));
+  POLYBENCH_VERIFY_2D("C", POLYBENCH_ARRAY(C), POLYBENCH_ARRAY(C_ref),
+		      ni, nj);
+#endif
+
   /* Be clean. */
   POLYBENCH_FREE_ARRAY(C);
   POLYBENCH_FREE_ARRAY(A);
   POLYBENCH_FREE_ARRAY(B);
-
-  return 0;
+#ifdef POLYBENCH_VERIFY
+  POLYBENCH_FREE_ARRAY(C_ref);
+#endif
+#ifdef POLYBENCH_TILED_LAYOUT
+  POLYBENCH_FREE_ARRAY(tC);
+  POLYBENCH_FREE_ARRAY(tA);
+  POLYBENCH_FREE_ARRAY(tB);
+#endif
+
+  return polybench_verify_status ();
 }
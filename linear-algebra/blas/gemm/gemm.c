@@ -54,6 +54,10 @@ void print_array(int ni, int nj,
 {
   int i, j;
 
+#ifdef POLYBENCH_CHECKSUM
+  POLYBENCH_CHECKSUM_2D("C", C, ni, nj);
+  return;
+#endif
   POLYBENCH_DUMP_START;
   POLYBENCH_DUMP_BEGIN("C");
   for (i = 0; i < ni; i++)
@@ -102,9 +106,9 @@ void kernel_gemm(int ni, int nj, int nk,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int ni = NI;
-  int nj = NJ;
-  int nk = NK;
+  int ni = POLYBENCH_SIZE(NI);
+  int nj = POLYBENCH_SIZE(NJ);
+  int nk = POLYBENCH_SIZE(NK);
 
   /* Variable declaration/allocation. */
   DATA_TYPE alpha;
@@ -113,11 +117,25 @@ int main(int argc, char** argv)
   POLYBENCH_2D_ARRAY_DECL(A,DATA_TYPE,NI,NK,ni,nk);
   POLYBENCH_2D_ARRAY_DECL(B,DATA_TYPE,NK,NJ,nk,nj);
 
-  /* Initialize array(s). */
-  init_array (ni, nj, nk, &alpha, &beta,
-	      POLYBENCH_ARRAY(C),
-	      POLYBENCH_ARRAY(A),
-	      POLYBENCH_ARRAY(B));
+  /* Data kept by the dataset cache, if enabled. */
+  polybench_dataset_scalar (alpha);
+  polybench_dataset_scalar (beta);
+  polybench_dataset_array (C);
+  polybench_dataset_array (A);
+  polybench_dataset_array (B);
+
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
+  /* Initialize array(s), unless the dataset cache holds them. */
+  if (! polybench_dataset_load ())
+    {
+      init_array (ni, nj, nk, &alpha, &beta,
+		  POLYBENCH_ARRAY(C),
+		  POLYBENCH_ARRAY(A),
+		  POLYBENCH_ARRAY(B));
+      polybench_dataset_store ();
+    }
 
   /* Start timer. */
   polybench_start_instruments;
@@ -131,6 +149,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
@@ -120,7 +120,7 @@ void kernel_gemver(int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
+  int n = POLYBENCH_SIZE(N);
 
   /* Variable declaration/allocation. */
   DATA_TYPE alpha;
@@ -136,6 +136,9 @@ int main(int argc, char** argv)
   POLYBENCH_1D_ARRAY_DECL(z, DATA_TYPE, N, n);
 
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (n, &alpha, &beta,
 	      POLYBENCH_ARRAY(A),
@@ -165,6 +168,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
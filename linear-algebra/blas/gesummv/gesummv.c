@@ -99,7 +99,7 @@ void kernel_gesummv(int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
+  int n = POLYBENCH_SIZE(N);
 
   /* Variable declaration/allocation. */
   DATA_TYPE alpha;
@@ -111,6 +111,9 @@ int main(int argc, char** argv)
   POLYBENCH_1D_ARRAY_DECL(y, DATA_TYPE, N, n);
 
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (n, &alpha, &beta,
 	      POLYBENCH_ARRAY(A),
@@ -130,6 +133,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
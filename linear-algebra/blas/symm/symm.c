@@ -108,8 +108,8 @@ void kernel_symm(int m, int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int m = M;
-  int n = N;
+  int m = POLYBENCH_SIZE(M);
+  int n = POLYBENCH_SIZE(N);
 
   /* Variable declaration/allocation. */
   DATA_TYPE alpha;
@@ -118,6 +118,9 @@ int main(int argc, char** argv)
   POLYBENCH_2D_ARRAY_DECL(A,DATA_TYPE,M,M,m,m);
   POLYBENCH_2D_ARRAY_DECL(B,DATA_TYPE,M,N,m,n);
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (m, n, &alpha, &beta,
 	      POLYBENCH_ARRAY(C),
@@ -136,6 +139,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
@@ -49,6 +49,15 @@
 # define _PB_N POLYBENCH_LOOP_BOUND(N,n)
 
 
+/* Analytic model, see utilities/polybench.spec: number of floating
+   point operations, and minimal memory traffic in array elements.
+   POLYBENCH_PROGRAM_SIZES lists the name and value of each parameter. */
+# define POLYBENCH_PROGRAM_FLOPS (2.0*(_PB_M)*(_PB_N)*((_PB_N)+1) + 1.5*(_PB_N)*((_PB_N)+1))
+# define POLYBENCH_PROGRAM_WORDS (2.0*(_PB_N)*(_PB_M) + 1.0*(_PB_N)*((_PB_N)+1))
+# define POLYBENCH_PROGRAM_SIZES "M", _PB_M, "N", _PB_N
+/* Name of the kernel, the directory of its variants. */
+# define POLYBENCH_KERNEL_NAME "syr2k"
+
 /* Default data type */
 # if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) && !defined(DATA_TYPE_IS_DOUBLE)
 #  define DATA_TYPE_IS_DOUBLE
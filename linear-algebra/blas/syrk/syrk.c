@@ -96,8 +96,8 @@ void kernel_syrk(int n, int m,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
-  int m = M;
+  int n = POLYBENCH_SIZE(N);
+  int m = POLYBENCH_SIZE(M);
 
   /* Variable declaration/allocation. */
   DATA_TYPE alpha;
@@ -105,6 +105,9 @@ int main(int argc, char** argv)
   POLYBENCH_2D_ARRAY_DECL(C,DATA_TYPE,N,N,n,n);
   POLYBENCH_2D_ARRAY_DECL(A,DATA_TYPE,N,M,n,m);
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (n, m, &alpha, &beta, POLYBENCH_ARRAY(C), POLYBENCH_ARRAY(A));
 
@@ -116,6 +119,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
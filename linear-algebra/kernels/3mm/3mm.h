@@ -67,6 +67,15 @@
 # define _PB_NM POLYBENCH_LOOP_BOUND(NM,nm)
 
 
+/* Analytic model, see utilities/polybench.spec: number of floating
+   point operations, and minimal memory traffic in array elements.
+   POLYBENCH_PROGRAM_SIZES lists the name and value of each parameter. */
+# define POLYBENCH_PROGRAM_FLOPS (2.0*(_PB_NI)*(_PB_NJ)*(_PB_NK) + 2.0*(_PB_NJ)*(_PB_NL)*(_PB_NM) + 2.0*(_PB_NI)*(_PB_NL)*(_PB_NJ))
+# define POLYBENCH_PROGRAM_WORDS (1.0*(_PB_NI)*(_PB_NK) + 1.0*(_PB_NK)*(_PB_NJ) + 1.0*(_PB_NJ)*(_PB_NM) + 1.0*(_PB_NM)*(_PB_NL) + 1.0*(_PB_NI)*(_PB_NL))
+# define POLYBENCH_PROGRAM_SIZES "NI", _PB_NI, "NJ", _PB_NJ, "NK", _PB_NK, "NL", _PB_NL, "NM", _PB_NM
+/* Name of the kernel, the directory of its variants. */
+# define POLYBENCH_KERNEL_NAME "3mm"
+
 /* Default data type */
 # if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) && !defined(DATA_TYPE_IS_DOUBLE)
 #  define DATA_TYPE_IS_DOUBLE
@@ -89,8 +89,8 @@ void kernel_atax(int m, int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int m = M;
-  int n = N;
+  int m = POLYBENCH_SIZE(M);
+  int n = POLYBENCH_SIZE(N);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(A, DATA_TYPE, M, N, m, n);
@@ -98,6 +98,9 @@ int main(int argc, char** argv)
   POLYBENCH_1D_ARRAY_DECL(y, DATA_TYPE, N, n);
   POLYBENCH_1D_ARRAY_DECL(tmp, DATA_TYPE, M, m);
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (m, n, POLYBENCH_ARRAY(A), POLYBENCH_ARRAY(x));
 
@@ -113,6 +116,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
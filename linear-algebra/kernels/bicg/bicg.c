@@ -99,8 +99,8 @@ void kernel_bicg(int m, int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
-  int m = M;
+  int n = POLYBENCH_SIZE(N);
+  int m = POLYBENCH_SIZE(M);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(A, DATA_TYPE, N, M, n, m);
@@ -109,6 +109,9 @@ int main(int argc, char** argv)
   POLYBENCH_1D_ARRAY_DECL(p, DATA_TYPE, M, m);
   POLYBENCH_1D_ARRAY_DECL(r, DATA_TYPE, N, n);
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (m, n,
 	      POLYBENCH_ARRAY(A),
@@ -128,6 +131,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
@@ -55,6 +55,15 @@
 # define _PB_NP POLYBENCH_LOOP_BOUND(NP,np)
 
 
+/* Analytic model, see utilities/polybench.spec: number of floating
+   point operations, and minimal memory traffic in array elements.
+   POLYBENCH_PROGRAM_SIZES lists the name and value of each parameter. */
+# define POLYBENCH_PROGRAM_FLOPS (2.0*(_PB_NR)*(_PB_NQ)*(_PB_NP)*(_PB_NP))
+# define POLYBENCH_PROGRAM_WORDS (2.0*(_PB_NR)*(_PB_NQ)*(_PB_NP) + 1.0*(_PB_NP)*(_PB_NP))
+# define POLYBENCH_PROGRAM_SIZES "NQ", _PB_NQ, "NR", _PB_NR, "NP", _PB_NP
+/* Name of the kernel, the directory of its variants. */
+# define POLYBENCH_KERNEL_NAME "doitgen"
+
 /* Default data type */
 # if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) && !defined(DATA_TYPE_IS_DOUBLE)
 #  define DATA_TYPE_IS_DOUBLE
@@ -62,7 +62,7 @@ void kernel_durbin(int n,
 		   DATA_TYPE POLYBENCH_1D(r,N,n),
 		   DATA_TYPE POLYBENCH_1D(y,N,n))
 {
- DATA_TYPE z[N];
+ DATA_TYPE POLYBENCH_1D_F(z,N,n);
  DATA_TYPE alpha;
  DATA_TYPE beta;
  DATA_TYPE sum;
@@ -98,13 +98,16 @@ void kernel_durbin(int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
+  int n = POLYBENCH_SIZE(N);
 
   /* Variable declaration/allocation. */
   POLYBENCH_1D_ARRAY_DECL(r, DATA_TYPE, N, n);
   POLYBENCH_1D_ARRAY_DECL(y, DATA_TYPE, N, n);
 
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (n, POLYBENCH_ARRAY(r));
 
@@ -118,6 +121,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
@@ -111,14 +111,17 @@ void kernel_gramschmidt(int m, int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int m = M;
-  int n = N;
+  int m = POLYBENCH_SIZE(M);
+  int n = POLYBENCH_SIZE(N);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(A,DATA_TYPE,M,N,m,n);
   POLYBENCH_2D_ARRAY_DECL(R,DATA_TYPE,N,N,n,n);
   POLYBENCH_2D_ARRAY_DECL(Q,DATA_TYPE,M,N,m,n);
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (m, n,
 	      POLYBENCH_ARRAY(A),
@@ -136,6 +139,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
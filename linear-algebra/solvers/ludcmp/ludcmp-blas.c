@@ -20,6 +20,9 @@
 /* Include benchmark-specific header. */
 #include "ludcmp.h"
 
+/* Include the reference implementation, for POLYBENCH_VERIFY. */
+#include "ludcmp-reference.h"
+
 #include <cblas.h>
 #include <lapacke.h>
 #include <assert.h>
@@ -82,6 +85,10 @@ void print_array(int n,
 {
   int i;
 
+#ifdef POLYBENCH_CHECKSUM
+  POLYBENCH_CHECKSUM_1D("x", x, n);
+  return;
+#endif
   POLYBENCH_DUMP_START;
   POLYBENCH_DUMP_BEGIN("x");
   for (i = 0; i < n; i++) {
@@ -105,31 +112,47 @@ void kernel_ludcmp(int n,
   int ipiv[n];
 
   #pragma scop
-  LAPACKE_dgetrf(CblasRowMajor, n, n, (double *) A, n, ipiv);
-  LAPACKE_dgetrs(CblasRowMajor, 'N', n, 1, (const double *) A, n, ipiv, b, 1); 	
+  LAPACKE_dgetrf(CblasRowMajor, n, n, (double *) A, POLYBENCH_LEADING_DIM(A), ipiv);
+  LAPACKE_dgetrs(CblasRowMajor, 'N', n, 1, (const double *) A, POLYBENCH_LEADING_DIM(A), ipiv, b, 1); 	
   memcpy(x, b, n * sizeof(double));
   #pragma endscop
 }
 
 
+
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = NN;
+  int n = POLYBENCH_NAMED_SIZE("N", NN);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(A, DATA_TYPE, NN, NN, n, n);
   POLYBENCH_1D_ARRAY_DECL(b, DATA_TYPE, NN, n);
   POLYBENCH_1D_ARRAY_DECL(x, DATA_TYPE, NN, n);
   POLYBENCH_1D_ARRAY_DECL(y, DATA_TYPE, NN, n);
+  LUDCMP_REFERENCE_DECL (n);
 
 
-  /* Initialize array(s). */
-  init_array (n,
-	      POLYBENCH_ARRAY(A),
-	      POLYBENCH_ARRAY(b),
-	      POLYBENCH_ARRAY(x),
-	      POLYBENCH_ARRAY(y));
+  /* Data kept by the dataset cache, if enabled. */
+  polybench_dataset_array (A);
+  polybench_dataset_array (b);
+  polybench_dataset_array (x);
+  polybench_dataset_array (y);
+
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
+  /* Initialize array(s), unless the dataset cache holds them. */
+  if (! polybench_dataset_load ())
+    {
+      init_array (n,
+		  POLYBENCH_ARRAY(A),
+		  POLYBENCH_ARRAY(b),
+		  POLYBENCH_ARRAY(x),
+		  POLYBENCH_ARRAY(y));
+      polybench_dataset_store ();
+    }
+  LUDCMP_REFERENCE_COPY;
 
   /* Start timer. */
   polybench_start_instruments;
@@ -143,17 +166,22 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
      by the function call in argument. */
   polybench_prevent_dce(print_array(n, POLYBENCH_ARRAY(x)));
 
+  /* With -DPOLYBENCH_VERIFY, compare with the reference. */
+  LUDCMP_REFERENCE_CHECK (n);
+
   /* Be clean. */
   POLYBENCH_FREE_ARRAY(A);
   POLYBENCH_FREE_ARRAY(b);
   POLYBENCH_FREE_ARRAY(x);
   POLYBENCH_FREE_ARRAY(y);
+  LUDCMP_REFERENCE_FREE;
 
-  return 0;
+  return polybench_verify_status ();
 }
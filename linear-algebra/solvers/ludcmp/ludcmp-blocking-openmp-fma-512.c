@@ -13,6 +13,9 @@
 /* Include benchmark-specific header. */
 #include "ludcmp.h"
 
+/* Include the reference implementation, for POLYBENCH_VERIFY. */
+#include "ludcmp-reference.h"
+
 #include <omp.h>
 #include <immintrin.h>
 
@@ -28,6 +31,7 @@ void init_array (int n,
   int i, j;
   DATA_TYPE fn = (DATA_TYPE)n;
 
+  polybench_parallel_init (j)
   for (i = 0; i < n; i++)
     {
       x[i] = 0;
@@ -35,6 +39,7 @@ void init_array (int n,
       b[i] = (i+1)/fn/2.0 + 4;
     }
 
+  polybench_parallel_init (j)
   for (i = 0; i < n; i++)
     {
       for (j = 0; j <= i; j++)
@@ -74,6 +79,10 @@ void print_array(int n,
 {
   int i;
 
+#ifdef POLYBENCH_CHECKSUM
+  POLYBENCH_CHECKSUM_1D("x", x, n);
+  return;
+#endif
   POLYBENCH_DUMP_START;
   POLYBENCH_DUMP_BEGIN("x");
   for (i = 0; i < n; i++) {
@@ -85,6 +94,7 @@ void print_array(int n,
 }
 
 
+static
 DATA_TYPE min(DATA_TYPE x, DATA_TYPE y) {
   if (x < y) {
     return x;
@@ -94,300 +104,164 @@ DATA_TYPE min(DATA_TYPE x, DATA_TYPE y) {
 }
 
 
-void invert_unity_lower_triangular_matrix(int d, DATA_TYPE L[d][d]) {
-    DATA_TYPE b[d][d];
-    memset(b, 0, sizeof(b));
-
-    for (int i = 0; i < d; i++) {
-        b[i][i] = 1; // diagonal
-    }
-
-    for (int i = 1; i < d; i++) {
-        for (int j = 0; j < i; j++) {
-            DATA_TYPE sum1 = 0.0;
-            DATA_TYPE sum2 = 0.0;
-            DATA_TYPE sum3 = 0.0;
-            DATA_TYPE sum4 = 0.0;
-
-            int k = j;
-            for (; k+4 <= i; k+=4) {
-                sum1 += L[i][k+0] * b[k+0][j];
-                sum2 += L[i][k+1] * b[k+1][j];
-                sum3 += L[i][k+2] * b[k+2][j];
-                sum4 += L[i][k+3] * b[k+3][j];
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 8; 
-                #endif
-            }
-            for (; k < i; k++) {
-                sum1 += L[i][k] * b[k][j];
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 2; 
-                #endif
-            }
-            sum1 += sum2;
-            sum3 += sum4;
-            sum1 += sum3;
-            b[i][j] = -sum1;
-        }
-    }
-
-    memcpy(L, b, sizeof(b));
-}
-
-void invert_upper_triangular_matrix(int d, DATA_TYPE U[d][d]) {
-    DATA_TYPE c[d][d];
-    memset(c, 0, sizeof(c));
-
-    for (int i = d-1; i >= 0; i--) {
-        c[i][i] = 1 / U[i][i]; // diagonal
-
-        #ifdef COUNT_FLOPS
-        FLOP_COUNTER += 1; 
-        #endif
-
-        for (int j = d-1; j >= i + 1; j--) {
-            DATA_TYPE sum1 = 0.0;
-            DATA_TYPE sum2 = 0.0;
-            DATA_TYPE sum3 = 0.0;
-            DATA_TYPE sum4 = 0.0;
-            int k = i+1;
-            for (; k+4 <= j; k+=4) {
-                sum1 += U[i][k] * c[k][j];
-                sum2 += U[i][k+1] * c[k+1][j];
-                sum3 += U[i][k+2] * c[k+2][j];
-                sum4 += U[i][k+3] * c[k+3][j];
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 2; 
-                #endif
-            }
-            for (; k <= j; k++) {
-                sum1 += U[i][k] * c[k][j];
- 
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 2; 
-                #endif
-            }
-            sum1 += sum2;
-            sum3 += sum4;
-            sum1 += sum3;
-            c[i][j] = -sum1 / U[i][i];
-
-            #ifdef COUNT_FLOPS
-            FLOP_COUNTER += 1; 
-            #endif
-        }
-    }
-
-        memcpy(U, c, sizeof(c));
-}
-
-// Equation 4 in the paper linked above
-// LU factorization according to Doolitte's method
+// Blocked right-looking LU factorization with partial pivoting, PA = LU
+// (the Doolittle scheme of the paper above, with the panel factorized
+// by columns so that its pivots can be chosen), in place: L, with its
+// unit diagonal implied, below the diagonal of A, and U above.
+// The row interchanges of the panel are recorded in ipiv, as in LAPACK's
+// getrf: row i was interchanged with row ipiv[i] >= i, in order. They
+// are applied to the panel as it is factorized, and to the columns on
+// its left and on its right in bulk, once per panel.
+static
 void block_lu_factorization_recursive_opt_avx_b16(
     int n,
     int o, // offset of submatrix (starting index for both x and y)
     int s, // max size of submatrix (exclusive)
-    DATA_TYPE A[n][n],
-    DATA_TYPE L[n][n],
-    DATA_TYPE U[n][n]
+    DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
+    int ipiv[n]
 ) {
 #ifdef DEBUG
     assert(s > 0);
     assert(n >= o + s);
 #endif
-    // Step 1: Compute l, u
-    DATA_TYPE l[s][s]; // Equivalent to L_11 in paper
-    DATA_TYPE u[s][s]; // Equivalent to U_11 in paper
-    memset(l, 0, sizeof(l));
-    memset(u, 0, sizeof(u));
-
-    DATA_TYPE a[s][s]; 
-    memset(a, 0, sizeof(a));
-    for (int i = 0; i < s; i++) {
-        for (int j = 0; j < s; j++) {
-            a[i][j] = A[i + o][j + o];
-        }
-    }
-
-    // Set diagonal of L
-    for (int i = 0; i < s; i++) {
-        l[i][i] = 1;
-    }
-    // See equation 4
-    for (int j = 0; j < s; j++) {
-        u[0][j] = A[o][o + j];
-    }
-    for (int i = 0; i < s; i++) {
-        l[i][0] = A[o + i][o] / u[0][0];
-
-        #ifdef COUNT_FLOPS
-        FLOP_COUNTER += 1; 
-        #endif
-    }
-    for (int k = 1; k < s; k++) {
-        for (int j = k; j < s; j++) {
-            DATA_TYPE sum1 = 0.0;
-            DATA_TYPE sum2 = 0.0;
-            DATA_TYPE sum3 = 0.0;
-            DATA_TYPE sum4 = 0.0;
-
-            int mrest = 0;
-            for (int m = mrest; m+4 <= k; m+=4) {
-                sum1 += l[k][m+0] * u[m+0][j];
-                sum2 += l[k][m+1] * u[m+1][j];
-                sum3 += l[k][m+2] * u[m+2][j];
-                sum4 += l[k][m+3] * u[m+3][j];
-                mrest = m + 4;
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 8; 
-                #endif
-            }
-            for (int m = mrest; m < k; m++) {
-                sum1 += l[k][m] * u[m][j];
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 2; 
-                #endif
+    // Step 1: Factorize the panel A[o:n][o:o+s] in place into L_11, L_21
+    // and U_11. Each thread keeps the same rows of the panel for all its
+    // columns: it scales and updates them, and looks for the pivot of the
+    // next column among them at the same time, so that a column costs two
+    // barriers. The candidates of the threads are reduced by the single
+    // thread which interchanges the rows. Short panels are factorized by
+    // one thread.
+    polybench_region_begin("panel factorization");
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    DATA_TYPE piv_val[nthreads];
+    int piv_row[nthreads];
+    #pragma omp parallel if (n - o >= 1024)
+    {
+        int t = 0;
+        int nt = 1;
+#ifdef _OPENMP
+        t = omp_get_thread_num();
+        nt = omp_get_num_threads();
+#endif
+        int r0 = o + (int) ((long) (n - o) * t / nt);
+        int r1 = o + (int) ((long) (n - o) * (t + 1) / nt);
+
+        int p = -1;
+        DATA_TYPE v = -1;
+        for (int i = r0; i < r1; i++) {
+            if (fabs(A[i][o]) > v) {
+                v = fabs(A[i][o]);
+                p = i;
             }
-            sum1 += sum2;
-            sum3 += sum4;
-            sum1 += sum3;
-            u[k][j] = A[o + k][o + j] - sum1;
-
-            #ifdef COUNT_FLOPS
-            FLOP_COUNTER += 4; 
-            #endif
         }
 
-        for (int i = k + 1; i < s; i++) {
-            DATA_TYPE sum1 = 0.0;
-            DATA_TYPE sum2 = 0.0;
-            DATA_TYPE sum3 = 0.0;
-            DATA_TYPE sum4 = 0.0;
-
-            int mrest = 0;
-            for (int m = mrest; m+4 <= k; m+=4) {
-                sum1 += l[i][m+0] * u[m+0][k];
-                sum2 += l[i][m+1] * u[m+1][k];
-                sum3 += l[i][m+2] * u[m+2][k];
-                sum4 += l[i][m+3] * u[m+3][k];
-                mrest = m + 4;
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 8; 
-                #endif
+        for (int k = 0; k < s; k++) {
+            piv_val[t] = v;
+            piv_row[t] = p;
+            #pragma omp barrier
+            #pragma omp single
+            {
+                // The first of the largest, whatever the number of threads.
+                int q = 0;
+                for (int u = 1; u < nt; u++) {
+                    if (piv_val[u] > piv_val[q]) {
+                        q = u;
+                    }
+                }
+                int r = piv_row[q] < 0 ? o + k : piv_row[q];
+                ipiv[o + k] = r;
+                if (r != o + k) {
+                    for (int j = 0; j < s; j++) {
+                        DATA_TYPE tmp = A[o + k][o + j];
+                        A[o + k][o + j] = A[r][o + j];
+                        A[r][o + j] = tmp;
+                    }
+                }
             }
-            for (int m = mrest; m < k; m++) {
-                sum1 += l[i][m] * u[m][k];
+
+            DATA_TYPE pivot = A[o + k][o + k];
+            p = -1;
+            v = -1;
+            for (int i = (r0 > o + k ? r0 : o + k + 1); i < r1; i++) {
+                A[i][o + k] /= pivot;
+                for (int j = k + 1; j < s; j++) {
+                    A[i][o + j] -= A[i][o + k] * A[o + k][o + j];
+                }
+                if (k + 1 < s && fabs(A[i][o + k + 1]) > v) {
+                    v = fabs(A[i][o + k + 1]);
+                    p = i;
+                }
 
                 #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 2; 
+                FLOP_COUNTER += 1 + 2 * (s - k - 1);
                 #endif
             }
-            sum1 += sum2;
-            sum3 += sum4;
-            sum1 += sum3;
-            l[i][k] = (A[o + i][o + k] - sum1) / u[k][k];
-
-            #ifdef COUNT_FLOPS
-            FLOP_COUNTER += 5; 
-            #endif
         }
     }
 
-    // Store into resulting L U matrices.
-    for (int i = 0; i < s; i++) {
-        for (int j = 0; j < s; j++) {
-            L[o + i][o + j] = l[i][j];
-            U[o + i][o + j] = u[i][j];
-        }
-    }
-
-    // Compute the inverse in-place.
-    invert_unity_lower_triangular_matrix(s, l);
-    invert_upper_triangular_matrix(s, u);
+    polybench_region_end("panel factorization");
 
-    
-    // Step 2: Compute U_12 = L_11^(-1) A_12
+    // Step 2: Apply the interchanges of the panel to the columns on its
+    // left (L) and on its right, in blocks of columns.
+    polybench_region_begin("row interchanges");
     #pragma omp parallel for
-    for (int i = 0; i < s; i++) {
-        for (int j = 0; j < n - o - s; j++) {
-            DATA_TYPE sum1 = 0.0;
-            DATA_TYPE sum2 = 0.0;
-            DATA_TYPE sum3 = 0.0;
-            DATA_TYPE sum4 = 0.0;
-
-            int krest = 0;
-            for (int k = krest; k+4 <= s; k+=4) {
-                sum1 += l[i][k+0] * A[o + k+0][o + s + j];
-                sum2 += l[i][k+1] * A[o + k+1][o + s + j];
-                sum3 += l[i][k+2] * A[o + k+2][o + s + j];
-                sum4 += l[i][k+3] * A[o + k+3][o + s + j];
-                krest = k + 4;
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 8; 
-                #endif
+    for (int jj = 0; jj < o; jj += 64) {
+        int je = min(jj + 64, o);
+        for (int k = o; k < o + s; k++) {
+            if (ipiv[k] != k) {
+                for (int j = jj; j < je; j++) {
+                    DATA_TYPE t = A[k][j];
+                    A[k][j] = A[ipiv[k]][j];
+                    A[ipiv[k]][j] = t;
+                }
             }
-            for (int k = krest; k < s; k++) {
-                sum1 += l[i][k] * A[o + k][o + s + j];
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 2; 
-                #endif
+        }
+    }
+    #pragma omp parallel for
+    for (int jj = o + s; jj < n; jj += 64) {
+        int je = min(jj + 64, n);
+        for (int k = o; k < o + s; k++) {
+            if (ipiv[k] != k) {
+                for (int j = jj; j < je; j++) {
+                    DATA_TYPE t = A[k][j];
+                    A[k][j] = A[ipiv[k]][j];
+                    A[ipiv[k]][j] = t;
+                }
             }
-            sum1 += sum2;
-            sum3 += sum4;
-            sum1 += sum3;
-            U[o + i][o + s + j] = sum1;
         }
     }
+    polybench_region_end("row interchanges");
 
-    // Step 3: Compute L_21 = A_21 U_11^(-1)
+    // Step 3: Compute U_12 = L_11^(-1) A_12 in place, by forward
+    // substitution with L_11, in blocks of columns.
+    polybench_region_begin("U_12");
     #pragma omp parallel for
-    for (int i = 0; i < n - o - s; i++) {
-        for (int j = 0; j < s; j++) {
-            DATA_TYPE sum1 = 0.0;
-            DATA_TYPE sum2 = 0.0;
-            DATA_TYPE sum3 = 0.0;
-            DATA_TYPE sum4 = 0.0;
-
-            int krest = 0;
-            for (int k = krest; k+4 <= s; k+=4) {
-                sum1 += A[o + s + i][o + k+0] * u[k+0][j];
-                sum2 += A[o + s + i][o + k+1] * u[k+1][j];
-                sum3 += A[o + s + i][o + k+2] * u[k+2][j];
-                sum4 += A[o + s + i][o + k+3] * u[k+3][j];
-                krest = k + 4;
-
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 8; 
-                #endif
+    for (int jj = o + s; jj < n; jj += 64) {
+        int je = min(jj + 64, n);
+        for (int i = 1; i < s; i++) {
+            for (int k = 0; k < i; k++) {
+                DATA_TYPE l = A[o + i][o + k];
+                for (int j = jj; j < je; j++) {
+                    A[o + i][j] -= l * A[o + k][j];
+                }
             }
-            for (int k = krest; k < s; k++) {
-                sum1 += A[o + s + i][o + k] * u[k][j];
 
-                #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 2; 
-                #endif
-            }
-            sum1 += sum2;
-            sum3 += sum4;
-            sum1 += sum3;
-            L[o  + s + i][o + j] = sum1;
+            #ifdef COUNT_FLOPS
+            FLOP_COUNTER += 2 * i * (je - jj);
+            #endif
         }
     }
+    polybench_region_end("U_12");
 
-    // Compute A_22'
+    // Step 4: Compute A_22' = A_22 - L_21 U_12
+    polybench_region_begin("A_22 update");
     #pragma omp parallel for
-    for (int i = o; i < n; i++) {
-        int jrest = o;
-        for (int j = jrest; j+8 <= n; j+=8) {
+    for (int i = o + s; i < n; i++) {
+        int jrest = o + s;
+        for (int j = jrest; j+16 <= n; j+=16) {
             __m512d sumv1 = _mm512_setzero_pd();
             __m512d sumv2 = _mm512_setzero_pd();
             __m512d sumv3 = _mm512_setzero_pd();
@@ -399,22 +273,20 @@ void block_lu_factorization_recursive_opt_avx_b16(
 
             int krest = 0;
             for (int k = krest; k+4 <= s; k+=4) {
-                __m512d LL = _mm512_loadu_pd(&L[i][o+k]); 
-
-                __m512d L1 = _mm512_set1_pd(((double *) &LL)[0]); 
-                __m512d L2 = _mm512_set1_pd(((double *) &LL)[1]); 
-                __m512d L3 = _mm512_set1_pd(((double *) &LL)[2]); 
-                __m512d L4 = _mm512_set1_pd(((double *) &LL)[3]); 
+                __m512d L1 = _mm512_set1_pd(A[i][o+k+0]);
+                __m512d L2 = _mm512_set1_pd(A[i][o+k+1]);
+                __m512d L3 = _mm512_set1_pd(A[i][o+k+2]);
+                __m512d L4 = _mm512_set1_pd(A[i][o+k+3]);
                 
-                __m512d U1 = _mm512_loadu_pd(&U[o+k+0][j]);
-                __m512d U2 = _mm512_loadu_pd(&U[o+k+1][j]);
-                __m512d U3 = _mm512_loadu_pd(&U[o+k+2][j]);
-                __m512d U4 = _mm512_loadu_pd(&U[o+k+3][j]);
+                __m512d U1 = _mm512_loadu_pd(&A[o+k+0][j]);
+                __m512d U2 = _mm512_loadu_pd(&A[o+k+1][j]);
+                __m512d U3 = _mm512_loadu_pd(&A[o+k+2][j]);
+                __m512d U4 = _mm512_loadu_pd(&A[o+k+3][j]);
 
-                __m512d U5 = _mm512_loadu_pd(&U[o+k+0][j+8]);
-                __m512d U6 = _mm512_loadu_pd(&U[o+k+1][j+8]);
-                __m512d U7 = _mm512_loadu_pd(&U[o+k+2][j+8]);
-                __m512d U8 = _mm512_loadu_pd(&U[o+k+3][j+8]);
+                __m512d U5 = _mm512_loadu_pd(&A[o+k+0][j+8]);
+                __m512d U6 = _mm512_loadu_pd(&A[o+k+1][j+8]);
+                __m512d U7 = _mm512_loadu_pd(&A[o+k+2][j+8]);
+                __m512d U8 = _mm512_loadu_pd(&A[o+k+3][j+8]);
 
                 sumv1 = _mm512_fmadd_pd(L1, U1, sumv1);
                 sumv2 = _mm512_fmadd_pd(L2, U2, sumv2);
@@ -425,10 +297,10 @@ void block_lu_factorization_recursive_opt_avx_b16(
                 sumv6 = _mm512_fmadd_pd(L2, U6, sumv6);
                 sumv7 = _mm512_fmadd_pd(L3, U7, sumv7);
                 sumv8 = _mm512_fmadd_pd(L4, U8, sumv8);
-                krest = k + 8;
+                krest = k + 4;
 
                 #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 64; 
+                FLOP_COUNTER += 128; 
                 #endif
             }
 
@@ -443,22 +315,22 @@ void block_lu_factorization_recursive_opt_avx_b16(
             sumv5 = _mm512_add_pd(sumv5, sumv7);
 
             #ifdef COUNT_FLOPS
-            FLOP_COUNTER += 24; 
+            FLOP_COUNTER += 48; 
             #endif
 
             __m512d A1 = _mm512_loadu_pd(&A[i][j]);
             __m512d A2 = _mm512_loadu_pd(&A[i][j+8]);
 
             for (int k = krest; k < s; k++) {
-                __m512d L1 = _mm512_set1_pd(L[i][o + k]); 
-                __m512d U1 = _mm512_loadu_pd(&U[o+k][j]);
+                __m512d L1 = _mm512_set1_pd(A[i][o + k]); 
+                __m512d U1 = _mm512_loadu_pd(&A[o+k][j]);
                 sumv1 = _mm512_fmadd_pd(L1, U1, sumv1);
 
-                __m512d U2 = _mm512_loadu_pd(&U[o+k][j+8]);
+                __m512d U2 = _mm512_loadu_pd(&A[o+k][j+8]);
                 sumv5 = _mm512_fmadd_pd(L1, U2, sumv5);
 
                 #ifdef COUNT_FLOPS
-                FLOP_COUNTER += 16; 
+                FLOP_COUNTER += 32; 
                 #endif
             }
 
@@ -469,10 +341,10 @@ void block_lu_factorization_recursive_opt_avx_b16(
             _mm512_storeu_pd(&A[i][j+8], A2);
             
             #ifdef COUNT_FLOPS
-            FLOP_COUNTER += 8; 
+            FLOP_COUNTER += 16; 
             #endif
 
-            jrest = j + 8;
+            jrest = j + 16;
         }
 
         for (int j = jrest; j < n; j++) {
@@ -483,17 +355,17 @@ void block_lu_factorization_recursive_opt_avx_b16(
 
             int k = 0;
             for (; k+4 <= s; k+=4) {
-                sum1 += L[i][o + k+0] * U[o + k+0][j];
-                sum2 += L[i][o + k+1] * U[o + k+1][j];
-                sum3 += L[i][o + k+2] * U[o + k+2][j];
-                sum4 += L[i][o + k+3] * U[o + k+3][j];
+                sum1 += A[i][o + k+0] * A[o + k+0][j];
+                sum2 += A[i][o + k+1] * A[o + k+1][j];
+                sum3 += A[i][o + k+2] * A[o + k+2][j];
+                sum4 += A[i][o + k+3] * A[o + k+3][j];
 
                 #ifdef COUNT_FLOPS
                 FLOP_COUNTER += 8; 
                 #endif
             }
             for (; k < s; k++) {
-                sum1 += L[i][o + k] * U[o + k][j];
+                sum1 += A[i][o + k] * A[o + k][j];
 
                 #ifdef COUNT_FLOPS
                 FLOP_COUNTER += 2; 
@@ -509,47 +381,59 @@ void block_lu_factorization_recursive_opt_avx_b16(
             #endif
         }
     }
+    polybench_region_end("A_22 update");
 
-    // Step 4: Recursively compute L_22, U_22
+    // Step 5: Recursively compute L_22, U_22
     int next_o = o + s;
     int next_s = min(s, n - next_o);
     if (next_s > 0) {
-        block_lu_factorization_recursive_opt_avx_b16(n, next_o, next_s, A, L, U);
+        block_lu_factorization_recursive_opt_avx_b16(n, next_o, next_s, A, ipiv);
     }
 }
 
 // Solves Ax=b for x
 // Modifies A, x, and b.
+static
 void block_lu_factorization_opt_avx_double_b16(int n,
 		   DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
 		   DATA_TYPE POLYBENCH_1D(b,NN,n),
 		   DATA_TYPE POLYBENCH_1D(x,NN,n),
 		   DATA_TYPE POLYBENCH_1D(y,NN,n)) {
     int s = min(16, n);
-    //DATA_TYPE L[n][n];
-    //DATA_TYPE U[n][n];
-    DATA_TYPE (*L)[n] = calloc(n * n, sizeof(DATA_TYPE));
-    DATA_TYPE (*U)[n] = calloc(n * n, sizeof(DATA_TYPE));
+    unsigned long mark = polybench_scratch_mark();
+    int *ipiv = polybench_scratch_alloc(sizeof(int[n]));
+
+    polybench_region_begin("factorization");
+    block_lu_factorization_recursive_opt_avx_b16(n, 0, s, A, ipiv);
+    polybench_region_end("factorization");
 
-    block_lu_factorization_recursive_opt_avx_b16(n, 0, s, A, L, U);
+    // Permute b as the rows of A: LUx = Pb
+    for (int i = 0; i < n; i++) {
+        if (ipiv[i] != i) {
+            DATA_TYPE t = b[i];
+            b[i] = b[ipiv[i]];
+            b[ipiv[i]] = t;
+        }
+    }
 
     // Solve Ly = b for y (forward substitution)
+    polybench_region_begin("forward substitution");
     for (int i = 0; i < n; i++) {
         __m512d sum1 = _mm512_set1_pd(0.0);
         __m512d sum2 = _mm512_set1_pd(0.0);
 
         int jrest = 0;
         for (int j = jrest; j+16<= i; j+=16) {
-            __m512d L1 = _mm512_loadu_pd(&L[i][j]);
+            __m512d L1 = _mm512_loadu_pd(&A[i][j]);
             __m512d y1 = _mm512_loadu_pd(&y[j]);
-            __m512d L2 = _mm512_loadu_pd(&L[i][j+4]);
-            __m512d y2 = _mm512_loadu_pd(&y[j+4]);
+            __m512d L2 = _mm512_loadu_pd(&A[i][j+8]);
+            __m512d y2 = _mm512_loadu_pd(&y[j+8]);
             sum1 = _mm512_fmadd_pd(L1, y1, sum1);
             sum2 = _mm512_fmadd_pd(L2, y2, sum2);
             jrest = j + 16;
 
             #ifdef COUNT_FLOPS
-            FLOP_COUNTER += 16; 
+            FLOP_COUNTER += 32; 
             #endif
         }
 
@@ -570,20 +454,22 @@ void block_lu_factorization_opt_avx_double_b16(int n,
         #endif
 
         for (int j = jrest; j < i; j++) {
-            sum += L[i][j] * y[j];
+            sum += A[i][j] * y[j];
 
             #ifdef COUNT_FLOPS
             FLOP_COUNTER += 2; 
             #endif
         }
 
-        y[i] = (b[i] - sum) / L[i][i];
+        y[i] = b[i] - sum;
 
         #ifdef COUNT_FLOPS
         FLOP_COUNTER += 1; 
         #endif
     }
+    polybench_region_end("forward substitution");
     // Solve Ux = y for x (back substitution)
+    polybench_region_begin("back substitution");
     for (int i = n - 1; i >= 0; i--) {
         DATA_TYPE sum1 = 0.0;
         DATA_TYPE sum2 = 0.0;
@@ -592,10 +478,10 @@ void block_lu_factorization_opt_avx_double_b16(int n,
 
         int jrest = i + 1;
         for (int j = jrest; j+4 <= n; j+=4) {
-            sum1 += U[i][j+0] * x[j+0];
-            sum1 += U[i][j+1] * x[j+1];
-            sum1 += U[i][j+2] * x[j+2];
-            sum1 += U[i][j+3] * x[j+3];
+            sum1 += A[i][j+0] * x[j+0];
+            sum1 += A[i][j+1] * x[j+1];
+            sum1 += A[i][j+2] * x[j+2];
+            sum1 += A[i][j+3] * x[j+3];
             jrest = j + 4;
 
             #ifdef COUNT_FLOPS
@@ -603,7 +489,7 @@ void block_lu_factorization_opt_avx_double_b16(int n,
             #endif
         }
         for (int j = jrest; j < n; j++) {
-            sum1 += U[i][j] * x[j];
+            sum1 += A[i][j] * x[j];
 
             #ifdef COUNT_FLOPS
             FLOP_COUNTER += 2; 
@@ -613,15 +499,15 @@ void block_lu_factorization_opt_avx_double_b16(int n,
         sum3 += sum4;
         sum1 += sum3;
 
-        x[i] = (y[i] - sum1) / U[i][i];
+        x[i] = (y[i] - sum1) / A[i][i];
 
         #ifdef COUNT_FLOPS
         FLOP_COUNTER += 5; 
         #endif
     }
+    polybench_region_end("back substitution");
 
-    free(L);
-    free(U);
+    polybench_scratch_release(mark);
 }
 
 /* Main computational kernel. The whole function will be timed,
@@ -642,24 +528,44 @@ void kernel_ludcmp(int n,
 }
 
 
+
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = NN;
+  int n = POLYBENCH_NAMED_SIZE("N", NN);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(A, DATA_TYPE, NN, NN, n, n);
   POLYBENCH_1D_ARRAY_DECL(b, DATA_TYPE, NN, n);
   POLYBENCH_1D_ARRAY_DECL(x, DATA_TYPE, NN, n);
   POLYBENCH_1D_ARRAY_DECL(y, DATA_TYPE, NN, n);
+  LUDCMP_REFERENCE_DECL (n);
+
+  /* Reserve the scratch storage of the kernel, the pivots, out of the
+     timed region. */
+  polybench_scratch_reserve (sizeof(int[n]) + POLYBENCH_ALIGNMENT);
 
 
-  /* Initialize array(s). */
-  init_array (n,
-	      POLYBENCH_ARRAY(A),
-	      POLYBENCH_ARRAY(b),
-	      POLYBENCH_ARRAY(x),
-	      POLYBENCH_ARRAY(y));
+  /* Data kept by the dataset cache, if enabled. */
+  polybench_dataset_array (A);
+  polybench_dataset_array (b);
+  polybench_dataset_array (x);
+  polybench_dataset_array (y);
+
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
+  /* Initialize array(s), unless the dataset cache holds them. */
+  if (! polybench_dataset_load ())
+    {
+      init_array (n,
+		  POLYBENCH_ARRAY(A),
+		  POLYBENCH_ARRAY(b),
+		  POLYBENCH_ARRAY(x),
+		  POLYBENCH_ARRAY(y));
+      polybench_dataset_store ();
+    }
+  LUDCMP_REFERENCE_COPY;
 
   /* Start timer. */
   polybench_start_instruments;
@@ -673,17 +579,23 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
      by the function call in argument. */
   polybench_prevent_dce(print_array(n, POLYBENCH_ARRAY(x)));
 
+  /* With -DPOLYBENCH_VERIFY, compare with the reference. */
+  LUDCMP_REFERENCE_CHECK (n);
+
   /* Be clean. */
   POLYBENCH_FREE_ARRAY(A);
   POLYBENCH_FREE_ARRAY(b);
   POLYBENCH_FREE_ARRAY(x);
   POLYBENCH_FREE_ARRAY(y);
+  LUDCMP_REFERENCE_FREE;
+  polybench_scratch_free ();
 
-  return 0;
+  return polybench_verify_status ();
 }
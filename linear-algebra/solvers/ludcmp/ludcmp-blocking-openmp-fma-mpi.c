@@ -76,6 +76,10 @@ void print_array(int n,
 {
   int i;
 
+#ifdef POLYBENCH_CHECKSUM
+  POLYBENCH_CHECKSUM_1D("x", x, n);
+  return;
+#endif
   POLYBENCH_DUMP_START;
   POLYBENCH_DUMP_BEGIN("x");
   for (i = 0; i < n; i++) {
@@ -87,6 +91,7 @@ void print_array(int n,
 }
 
 
+static
 DATA_TYPE min(DATA_TYPE x, DATA_TYPE y) {
   if (x < y) {
     return x;
@@ -96,9 +101,11 @@ DATA_TYPE min(DATA_TYPE x, DATA_TYPE y) {
 }
 
 
+static
 void invert_unity_lower_triangular_matrix(int d, DATA_TYPE L[d][d]) {
-    DATA_TYPE b[d][d];
-    memset(b, 0, sizeof(b));
+    unsigned long mark = polybench_scratch_mark();
+    DATA_TYPE (*b)[d] = polybench_scratch_alloc(sizeof(DATA_TYPE[d][d]));
+    memset(b, 0, sizeof(DATA_TYPE[d][d]));
 
     for (int i = 0; i < d; i++) {
         b[i][i] = 1; // diagonal
@@ -136,12 +143,15 @@ void invert_unity_lower_triangular_matrix(int d, DATA_TYPE L[d][d]) {
         }
     }
 
-    memcpy(L, b, sizeof(b));
+    memcpy(L, b, sizeof(DATA_TYPE[d][d]));
+    polybench_scratch_release(mark);
 }
 
+static
 void invert_upper_triangular_matrix(int d, DATA_TYPE U[d][d]) {
-    DATA_TYPE c[d][d];
-    memset(c, 0, sizeof(c));
+    unsigned long mark = polybench_scratch_mark();
+    DATA_TYPE (*c)[d] = polybench_scratch_alloc(sizeof(DATA_TYPE[d][d]));
+    memset(c, 0, sizeof(DATA_TYPE[d][d]));
 
     for (int i = d-1; i >= 0; i--) {
         c[i][i] = 1 / U[i][i]; // diagonal
@@ -184,15 +194,17 @@ void invert_upper_triangular_matrix(int d, DATA_TYPE U[d][d]) {
         }
     }
 
-        memcpy(U, c, sizeof(c));
+        memcpy(U, c, sizeof(DATA_TYPE[d][d]));
+        polybench_scratch_release(mark);
 }
 
+static
 void block_lu_factorization_recursive_opt_avx_rank_0(
     int n,
     int o,
     int s,
     DATA_TYPE l[s][s],
-    DATA_TYPE A[n][n],
+    DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
     DATA_TYPE L[n][n],
     DATA_TYPE U[n][n]
 ) {
@@ -236,9 +248,10 @@ void block_lu_factorization_recursive_opt_avx_rank_0(
     }
 }
 
+static
 void block_lu_factorization_recursive_opt_avx_rank_1(
     int n,
-    DATA_TYPE A[n][n],
+    DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
     DATA_TYPE L[n][n],
     DATA_TYPE U[n][n]
 ) {
@@ -306,11 +319,12 @@ void block_lu_factorization_recursive_opt_avx_rank_1(
 
 // Equation 4 in the paper linked above
 // LU factorization according to Doolitte's method
+static
 void block_lu_factorization_recursive_opt_avx(
     int n,
     int o, // offset of submatrix (starting index for both x and y)
     int s, // max size of submatrix (exclusive)
-    DATA_TYPE A[n][n],
+    DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
     DATA_TYPE L[n][n],
     DATA_TYPE U[n][n]
 ) {
@@ -319,14 +333,15 @@ void block_lu_factorization_recursive_opt_avx(
     assert(n >= o + s);
 #endif
 
-    DATA_TYPE l[s][s]; // Equivalent to L_11 in paper 
-    DATA_TYPE u[s][s]; // Equivalent to U_11 in paper
-    memset(l, 0, sizeof(l));
-    memset(u, 0, sizeof(u));
+    unsigned long mark = polybench_scratch_mark();
+    DATA_TYPE (*l)[s] = polybench_scratch_alloc(sizeof(DATA_TYPE[s][s])); // Equivalent to L_11 in paper 
+    DATA_TYPE (*u)[s] = polybench_scratch_alloc(sizeof(DATA_TYPE[s][s])); // Equivalent to U_11 in paper
+    memset(l, 0, sizeof(DATA_TYPE[s][s]));
+    memset(u, 0, sizeof(DATA_TYPE[s][s]));
 
     // Step 1: Compute l, u
-    DATA_TYPE a[s][s]; 
-    memset(a, 0, sizeof(a));
+    DATA_TYPE (*a)[s] = polybench_scratch_alloc(sizeof(DATA_TYPE[s][s]));
+    memset(a, 0, sizeof(DATA_TYPE[s][s]));
     for (int i = 0; i < s; i++) {
         for (int j = 0; j < s; j++) {
             a[i][j] = A[i + o][j + o];
@@ -566,6 +581,8 @@ void block_lu_factorization_recursive_opt_avx(
         }
     }
 
+    polybench_scratch_release(mark);
+
     // Step 4: Recursively compute L_22, U_22
     int next_o = o + s;
     int next_s = min(s, n - next_o);
@@ -580,6 +597,7 @@ void block_lu_factorization_recursive_opt_avx(
 
 // Solves Ax=b for x
 // Modifies A, x, and b.
+static
 void block_lu_factorization_opt_avx_double(int n,
 		   DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
 		   DATA_TYPE POLYBENCH_1D(b,NN,n),
@@ -589,8 +607,11 @@ void block_lu_factorization_opt_avx_double(int n,
     int s = min(16, n);
     //DATA_TYPE L[n][n];
     //DATA_TYPE U[n][n];
-    DATA_TYPE (*L)[n] = calloc(n * n, sizeof(DATA_TYPE));
-    DATA_TYPE (*U)[n] = calloc(n * n, sizeof(DATA_TYPE));
+    unsigned long mark = polybench_scratch_mark();
+    DATA_TYPE (*L)[n] = polybench_scratch_alloc(sizeof(DATA_TYPE[n][n]));
+    DATA_TYPE (*U)[n] = polybench_scratch_alloc(sizeof(DATA_TYPE[n][n]));
+    memset(L, 0, sizeof(DATA_TYPE[n][n]));
+    memset(U, 0, sizeof(DATA_TYPE[n][n]));
 
     block_lu_factorization_recursive_opt_avx(n, 0, s, A, L, U);
 
@@ -678,8 +699,7 @@ void block_lu_factorization_opt_avx_double(int n,
     }
     
 
-    free(L);
-    free(U);
+    polybench_scratch_release(mark);
 }
 
 /* Main computational kernel. The whole function will be timed,
@@ -711,7 +731,7 @@ int main(int argc, char** argv)
 
 
   /* Retrieve problem size. */
-  int n = NN;
+  int n = POLYBENCH_NAMED_SIZE("N", NN);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(A, DATA_TYPE, NN, NN, n, n);
@@ -721,6 +741,16 @@ int main(int argc, char** argv)
   POLYBENCH_1D_ARRAY_DECL(x, DATA_TYPE, NN, n);
   POLYBENCH_1D_ARRAY_DECL(y, DATA_TYPE, NN, n);
 
+  /* Reserve the scratch storage of the kernel, L, U and the diagonal
+     blocks, out of the timed region. */
+  polybench_scratch_reserve (2 * sizeof(DATA_TYPE[n][n])
+			     + 4 * sizeof(DATA_TYPE[16][16])
+			     + 2 * POLYBENCH_ALIGNMENT);
+
+    /* Repeat initialization and kernel execution, if requested. Rank 1
+       serves one factorization per run. */
+    polybench_repeat_begin;
+
     if (rank == 0) {
 
         /* Initialize array(s). */
@@ -740,16 +770,21 @@ int main(int argc, char** argv)
                 POLYBENCH_ARRAY(x),
                 POLYBENCH_ARRAY(y));
 
-        /* Stop and print timer. */
+        /* Stop timer. */
         polybench_stop_instruments;
+
+    } else if (rank == 1) {
+        block_lu_factorization_recursive_opt_avx_rank_1(n, POLYBENCH_ARRAY(A), POLYBENCH_ARRAY(L), POLYBENCH_ARRAY(U));
+    }
+    polybench_repeat_end;
+
+    if (rank == 0) {
+        /* Print timer. */
         polybench_print_instruments;
 
         /* Prevent dead-code elimination. All live-out data must be printed
             by the function call in argument. */
         polybench_prevent_dce(print_array(n, POLYBENCH_ARRAY(x)));
-
-    } else if (rank == 1) {
-        block_lu_factorization_recursive_opt_avx_rank_1(n, POLYBENCH_ARRAY(A), POLYBENCH_ARRAY(L), POLYBENCH_ARRAY(U));
     }
 
   /* Be clean. */
@@ -757,6 +792,7 @@ int main(int argc, char** argv)
   POLYBENCH_FREE_ARRAY(b);
   POLYBENCH_FREE_ARRAY(x);
   POLYBENCH_FREE_ARRAY(y);
+  polybench_scratch_free ();
 
 
   MPI_Finalize();
@@ -0,0 +1,558 @@
+
+// Tiled variant of ludcmp-blocking-openmp-fma.c, scheduled as a task
+// graph with lookahead instead of fork-join parallel loops per step.
+
+#include <stdio.h>
+#include <unistd.h>
+#include <string.h>
+#include <math.h>
+
+/* Include polybench common header. */
+#include <polybench.h>
+
+/* Include benchmark-specific header. */
+#include "ludcmp.h"
+
+/* Include the reference implementation, for POLYBENCH_VERIFY. */
+#include "ludcmp-reference.h"
+
+#include <omp.h>
+#include <immintrin.h>
+
+/* Number of rows and columns of a tile. Smaller tiles make more tasks
+   for many threads on small matrices, at the cost of more traffic. */
+#ifndef TILE_SIZE
+# define TILE_SIZE 256
+#endif
+
+
+/* Array initialization. */
+static
+void init_array (int n,
+		 DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
+		 DATA_TYPE POLYBENCH_1D(b,NN,n),
+		 DATA_TYPE POLYBENCH_1D(x,NN,n),
+		 DATA_TYPE POLYBENCH_1D(y,NN,n))
+{
+  int i, j;
+  DATA_TYPE fn = (DATA_TYPE)n;
+
+  polybench_parallel_init (j)
+  for (i = 0; i < n; i++)
+    {
+      x[i] = 0;
+      y[i] = 0;
+      b[i] = (i+1)/fn/2.0 + 4;
+    }
+
+  polybench_parallel_init (j)
+  for (i = 0; i < n; i++)
+    {
+      for (j = 0; j <= i; j++)
+	A[i][j] = (DATA_TYPE)(-j % n) / n + 1;
+      for (j = i+1; j < n; j++) {
+	A[i][j] = 0;
+      }
+      A[i][i] = 1;
+    }
+
+  /* Make the matrix positive semi-definite. */
+  /* not necessary for LU, but using same code as cholesky */
+  /*
+  int r,s,t;
+  POLYBENCH_2D_ARRAY_DECL(B, DATA_TYPE, NN, NN, n, n);
+  for (r = 0; r < n; ++r)
+    for (s = 0; s < n; ++s)
+      (POLYBENCH_ARRAY(B))[r][s] = 0;
+  for (t = 0; t < n; ++t)
+    for (r = 0; r < n; ++r)
+      for (s = 0; s < n; ++s)
+	(POLYBENCH_ARRAY(B))[r][s] += A[r][t] * A[s][t];
+    for (r = 0; r < n; ++r)
+      for (s = 0; s < n; ++s)
+	A[r][s] = (POLYBENCH_ARRAY(B))[r][s];
+  POLYBENCH_FREE_ARRAY(B);
+    */
+}
+
+
+/* DCE code. Must scan the entire live-out data.
+   Can be used also to check the correctness of the output. */
+static
+void print_array(int n,
+		 DATA_TYPE POLYBENCH_1D(x,NN,n))
+
+{
+  int i;
+
+#ifdef POLYBENCH_CHECKSUM
+  POLYBENCH_CHECKSUM_1D("x", x, n);
+  return;
+#endif
+  POLYBENCH_DUMP_START;
+  POLYBENCH_DUMP_BEGIN("x");
+  for (i = 0; i < n; i++) {
+    if (i % 20 == 0) fprintf (POLYBENCH_DUMP_TARGET, "\n");
+    fprintf (POLYBENCH_DUMP_TARGET, DATA_PRINTF_MODIFIER, x[i]);
+  }
+  POLYBENCH_DUMP_END("x");
+  POLYBENCH_DUMP_FINISH;
+}
+
+
+static
+DATA_TYPE min(DATA_TYPE x, DATA_TYPE y) {
+  if (x < y) {
+    return x;
+  } else {
+    return y;
+  }
+}
+
+
+// A[i0:i1][j0:j1] -= A[i0:i1][k0:k1] A[k0:k1][j0:j1], for blocks which
+// do not overlap. Each strip of 8 columns of A[k0:k1][j0:j1] is first
+// copied to a contiguous buffer, as its rows are n elements apart and
+// would otherwise conflict in the cache, then is multiplied with blocks
+// of 4 rows of A[i0:i1][k0:k1], held in registers.
+static
+void tile_gemm(int n, int i0, int i1, int j0, int j1, int k0, int k1,
+               DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n)) {
+    (void) n; // Only in the array dimensions, with C99 prototypes.
+    DATA_TYPE u[k1 - k0][8];
+
+    int j = j0;
+    for (; j+8 <= j1; j+=8) {
+        for (int k = k0; k < k1; k++) {
+            _mm256_storeu_pd(&u[k - k0][0], _mm256_loadu_pd(&A[k][j]));
+            _mm256_storeu_pd(&u[k - k0][4], _mm256_loadu_pd(&A[k][j+4]));
+        }
+
+        int i = i0;
+        for (; i+4 <= i1; i+=4) {
+            __m256d sumv1 = _mm256_setzero_pd();
+            __m256d sumv2 = _mm256_setzero_pd();
+            __m256d sumv3 = _mm256_setzero_pd();
+            __m256d sumv4 = _mm256_setzero_pd();
+            __m256d sumv5 = _mm256_setzero_pd();
+            __m256d sumv6 = _mm256_setzero_pd();
+            __m256d sumv7 = _mm256_setzero_pd();
+            __m256d sumv8 = _mm256_setzero_pd();
+
+            for (int k = k0; k < k1; k++) {
+                __m256d U1 = _mm256_loadu_pd(&u[k - k0][0]);
+                __m256d U2 = _mm256_loadu_pd(&u[k - k0][4]);
+
+                __m256d L1 = _mm256_set1_pd(A[i+0][k]);
+                __m256d L2 = _mm256_set1_pd(A[i+1][k]);
+                __m256d L3 = _mm256_set1_pd(A[i+2][k]);
+                __m256d L4 = _mm256_set1_pd(A[i+3][k]);
+
+                sumv1 = _mm256_fmadd_pd(L1, U1, sumv1);
+                sumv2 = _mm256_fmadd_pd(L1, U2, sumv2);
+                sumv3 = _mm256_fmadd_pd(L2, U1, sumv3);
+                sumv4 = _mm256_fmadd_pd(L2, U2, sumv4);
+                sumv5 = _mm256_fmadd_pd(L3, U1, sumv5);
+                sumv6 = _mm256_fmadd_pd(L3, U2, sumv6);
+                sumv7 = _mm256_fmadd_pd(L4, U1, sumv7);
+                sumv8 = _mm256_fmadd_pd(L4, U2, sumv8);
+            }
+
+            _mm256_storeu_pd(&A[i+0][j], _mm256_sub_pd(_mm256_loadu_pd(&A[i+0][j]), sumv1));
+            _mm256_storeu_pd(&A[i+0][j+4], _mm256_sub_pd(_mm256_loadu_pd(&A[i+0][j+4]), sumv2));
+            _mm256_storeu_pd(&A[i+1][j], _mm256_sub_pd(_mm256_loadu_pd(&A[i+1][j]), sumv3));
+            _mm256_storeu_pd(&A[i+1][j+4], _mm256_sub_pd(_mm256_loadu_pd(&A[i+1][j+4]), sumv4));
+            _mm256_storeu_pd(&A[i+2][j], _mm256_sub_pd(_mm256_loadu_pd(&A[i+2][j]), sumv5));
+            _mm256_storeu_pd(&A[i+2][j+4], _mm256_sub_pd(_mm256_loadu_pd(&A[i+2][j+4]), sumv6));
+            _mm256_storeu_pd(&A[i+3][j], _mm256_sub_pd(_mm256_loadu_pd(&A[i+3][j]), sumv7));
+            _mm256_storeu_pd(&A[i+3][j+4], _mm256_sub_pd(_mm256_loadu_pd(&A[i+3][j+4]), sumv8));
+
+            #ifdef COUNT_FLOPS
+            FLOP_COUNTER += 64 * (k1 - k0) + 32;
+            #endif
+        }
+
+        for (; i < i1; i++) {
+            __m256d sumv1 = _mm256_setzero_pd();
+            __m256d sumv2 = _mm256_setzero_pd();
+
+            for (int k = k0; k < k1; k++) {
+                __m256d L1 = _mm256_set1_pd(A[i][k]);
+                sumv1 = _mm256_fmadd_pd(L1, _mm256_loadu_pd(&u[k - k0][0]), sumv1);
+                sumv2 = _mm256_fmadd_pd(L1, _mm256_loadu_pd(&u[k - k0][4]), sumv2);
+            }
+
+            _mm256_storeu_pd(&A[i][j], _mm256_sub_pd(_mm256_loadu_pd(&A[i][j]), sumv1));
+            _mm256_storeu_pd(&A[i][j+4], _mm256_sub_pd(_mm256_loadu_pd(&A[i][j+4]), sumv2));
+
+            #ifdef COUNT_FLOPS
+            FLOP_COUNTER += 16 * (k1 - k0) + 8;
+            #endif
+        }
+    }
+
+    for (; j < j1; j++) {
+        for (int i = i0; i < i1; i++) {
+            DATA_TYPE sum = 0.0;
+            for (int k = k0; k < k1; k++) {
+                sum += A[i][k] * A[k][j];
+            }
+            A[i][j] -= sum;
+
+            #ifdef COUNT_FLOPS
+            FLOP_COUNTER += 2 * (k1 - k0) + 1;
+            #endif
+        }
+    }
+}
+
+// A[k0:k1][j0:j1] = L^(-1) A[k0:k1][j0:j1], by forward substitution with
+// the unit lower triangular L = A[k0:k1][k0:k1].
+static
+void tile_trsm(int n, int k0, int k1, int j0, int j1,
+               DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n)) {
+    (void) n;
+    for (int i = k0 + 1; i < k1; i++) {
+        for (int k = k0; k < i; k++) {
+            DATA_TYPE l = A[i][k];
+            for (int j = j0; j < j1; j++) {
+                A[i][j] -= l * A[k][j];
+            }
+        }
+
+        #ifdef COUNT_FLOPS
+        FLOP_COUNTER += 2 * (i - k0) * (j1 - j0);
+        #endif
+    }
+}
+
+// Interchanges the rows of the columns A[][c:c+w] as recorded in
+// ipiv[r0:r1], in order.
+static
+void tile_row_interchanges(int n, int c, int w, int r0, int r1,
+                           DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
+                           int ipiv[n]) {
+    for (int r = r0; r < r1; r++) {
+        if (ipiv[r] != r) {
+            for (int j = c; j < c + w; j++) {
+                DATA_TYPE t = A[r][j];
+                A[r][j] = A[ipiv[r]][j];
+                A[ipiv[r]][j] = t;
+            }
+        }
+    }
+}
+
+// Factorizes the panel A[o:n][o:o+s] in place with partial pivoting,
+// recording the row interchanges in ipiv[o:o+s] as LAPACK's getrf does:
+// row i was interchanged with row ipiv[i] >= i, in order. Only the
+// columns of the panel are interchanged.
+// The panel is split recursively in two halves of columns: the left
+// half is factorized, the right half is updated with it, then is
+// factorized, and its interchanges are applied to the left half. Most
+// of the work is then the update of the right halves, split in blocks
+// of rows among the idle threads with a taskloop; only the columns of
+// the narrowest panels are factorized one by one, by one thread.
+static
+void tile_panel_factorization(int n, int o, int s,
+                              DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
+                              int ipiv[n]) {
+    if (s <= 8) {
+        for (int k = 0; k < s; k++) {
+            int p = o + k;
+            for (int i = o + k + 1; i < n; i++) {
+                if (fabs(A[i][o + k]) > fabs(A[p][o + k])) {
+                    p = i;
+                }
+            }
+            ipiv[o + k] = p;
+            if (p != o + k) {
+                for (int j = 0; j < s; j++) {
+                    DATA_TYPE t = A[o + k][o + j];
+                    A[o + k][o + j] = A[p][o + j];
+                    A[p][o + j] = t;
+                }
+            }
+
+            DATA_TYPE pivot = A[o + k][o + k];
+            for (int i = o + k + 1; i < n; i++) {
+                A[i][o + k] /= pivot;
+                for (int j = k + 1; j < s; j++) {
+                    A[i][o + j] -= A[i][o + k] * A[o + k][o + j];
+                }
+
+                #ifdef COUNT_FLOPS
+                FLOP_COUNTER += 1 + 2 * (s - k - 1);
+                #endif
+            }
+        }
+        return;
+    }
+
+    int h = s / 2;
+    tile_panel_factorization(n, o, h, A, ipiv);
+    tile_row_interchanges(n, o + h, s - h, o, o + h, A, ipiv);
+    tile_trsm(n, o, o + h, o + h, o + s, A);
+    #pragma omp taskloop grainsize(1) priority(1)
+    for (int i = o + h; i < n; i += TILE_SIZE) {
+        tile_gemm(n, i, min(i + TILE_SIZE, n), o + h, o + s, o, o + h, A);
+    }
+    tile_panel_factorization(n, o + h, s - h, A, ipiv);
+    tile_row_interchanges(n, o, h, o + h, o + s, A, ipiv);
+}
+
+// LU factorization with partial pivoting, PA = LU, in place in A (L
+// below the diagonal, with a unit diagonal, and U above), on tiles of
+// TILE_SIZE x TILE_SIZE elements.
+// Instead of parallel loops and barriers per step, each step is a set of
+// tasks ordered by their dependencies on the tile columns only:
+// - the factorization of the panel, the tile column of the step, which
+//   writes the column (inout);
+// - for each tile column on its right, the row interchanges and U_12,
+//   which read the panel (in) and write the column (inout);
+// - for each tile of the trailing matrix, A_22' = A_22 - L_21 U_12 on the
+//   tile, which reads the panel and its own column (in, as the tiles of
+//   a column are updated at the same time).
+// A task which writes a column waits for all the tasks of the previous
+// step on it. So the panel of step k+1 waits for the update of its own
+// column by step k, not for the rest of the trailing matrix, and runs
+// ahead (lookahead) while the other tiles are updated. The tasks of this
+// critical path have a higher priority, honoured with
+// OMP_MAX_TASK_PRIORITY >= 1.
+// The row interchanges of the later steps are applied to the columns of
+// L in bulk at the end, one task per tile column.
+static
+void tile_lu_factorization_tasks(int n,
+                                 DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
+                                 int ipiv[n]) {
+    int nt = (n + TILE_SIZE - 1) / TILE_SIZE;
+    char col[nt]; // One dependency per tile column.
+    (void) col;
+
+    #pragma omp parallel
+    #pragma omp single
+    {
+        for (int k = 0; k < nt; k++) {
+            int o = k * TILE_SIZE;
+            int s = min(TILE_SIZE, n - o);
+
+            #pragma omp task depend(inout: col[k]) priority(1)
+            tile_panel_factorization(n, o, s, A, ipiv);
+
+            for (int j = k + 1; j < nt; j++) {
+                int c = j * TILE_SIZE;
+                int w = min(TILE_SIZE, n - c);
+
+                #pragma omp task depend(in: col[k]) depend(inout: col[j]) priority(j == k + 1)
+                {
+                    tile_row_interchanges(n, c, w, o, o + s, A, ipiv);
+                    tile_trsm(n, o, o + s, c, c + w, A);
+                }
+
+                for (int i = k + 1; i < nt; i++) {
+                    int r = i * TILE_SIZE;
+
+                    #pragma omp task depend(in: col[k], col[j]) priority(j == k + 1)
+                    tile_gemm(n, r, min(r + TILE_SIZE, n), c, c + w, o, o + s, A);
+                }
+            }
+        }
+
+        for (int j = 0; j < nt - 1; j++) {
+            int c = j * TILE_SIZE;
+
+            #pragma omp task depend(in: col[nt - 1]) depend(inout: col[j])
+            tile_row_interchanges(n, c, TILE_SIZE, c + TILE_SIZE, n, A, ipiv);
+        }
+    }
+}
+
+// Solves Ax=b for x
+// Modifies A, x, and b.
+static
+void tile_lu_solve_tasks(int n,
+                         DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
+                         DATA_TYPE POLYBENCH_1D(b,NN,n),
+                         DATA_TYPE POLYBENCH_1D(x,NN,n),
+                         DATA_TYPE POLYBENCH_1D(y,NN,n)) {
+    unsigned long mark = polybench_scratch_mark();
+    int *ipiv = polybench_scratch_alloc(sizeof(int[n]));
+
+    polybench_region_begin("factorization");
+    tile_lu_factorization_tasks(n, A, ipiv);
+    polybench_region_end("factorization");
+
+    // Permute b as the rows of A: LUx = Pb
+    for (int i = 0; i < n; i++) {
+        if (ipiv[i] != i) {
+            DATA_TYPE t = b[i];
+            b[i] = b[ipiv[i]];
+            b[ipiv[i]] = t;
+        }
+    }
+
+    // Solve Ly = b for y (forward substitution)
+    polybench_region_begin("forward substitution");
+    for (int i = 0; i < n; i++) {
+        DATA_TYPE sum1 = 0.0;
+        DATA_TYPE sum2 = 0.0;
+        DATA_TYPE sum3 = 0.0;
+        DATA_TYPE sum4 = 0.0;
+
+        int j = 0;
+        for (; j+4 <= i; j+=4) {
+            sum1 += A[i][j+0] * y[j+0];
+            sum2 += A[i][j+1] * y[j+1];
+            sum3 += A[i][j+2] * y[j+2];
+            sum4 += A[i][j+3] * y[j+3];
+
+            #ifdef COUNT_FLOPS
+            FLOP_COUNTER += 8;
+            #endif
+        }
+        for (; j < i; j++) {
+            sum1 += A[i][j] * y[j];
+
+            #ifdef COUNT_FLOPS
+            FLOP_COUNTER += 2;
+            #endif
+        }
+        sum1 += sum2;
+        sum3 += sum4;
+        sum1 += sum3;
+
+        y[i] = b[i] - sum1;
+
+        #ifdef COUNT_FLOPS
+        FLOP_COUNTER += 4;
+        #endif
+    }
+    polybench_region_end("forward substitution");
+
+    // Solve Ux = y for x (back substitution)
+    polybench_region_begin("back substitution");
+    for (int i = n - 1; i >= 0; i--) {
+        DATA_TYPE sum1 = 0.0;
+        DATA_TYPE sum2 = 0.0;
+        DATA_TYPE sum3 = 0.0;
+        DATA_TYPE sum4 = 0.0;
+
+        int j = i + 1;
+        for (; j+4 <= n; j+=4) {
+            sum1 += A[i][j+0] * x[j+0];
+            sum2 += A[i][j+1] * x[j+1];
+            sum3 += A[i][j+2] * x[j+2];
+            sum4 += A[i][j+3] * x[j+3];
+
+            #ifdef COUNT_FLOPS
+            FLOP_COUNTER += 8;
+            #endif
+        }
+        for (; j < n; j++) {
+            sum1 += A[i][j] * x[j];
+
+            #ifdef COUNT_FLOPS
+            FLOP_COUNTER += 2;
+            #endif
+        }
+        sum1 += sum2;
+        sum3 += sum4;
+        sum1 += sum3;
+
+        x[i] = (y[i] - sum1) / A[i][i];
+
+        #ifdef COUNT_FLOPS
+        FLOP_COUNTER += 5;
+        #endif
+    }
+    polybench_region_end("back substitution");
+
+    polybench_scratch_release(mark);
+}
+
+/* Main computational kernel. The whole function will be timed,
+   including the call and return. */
+static
+void kernel_ludcmp(int n,
+		   DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
+		   DATA_TYPE POLYBENCH_1D(b,NN,n),
+		   DATA_TYPE POLYBENCH_1D(x,NN,n),
+		   DATA_TYPE POLYBENCH_1D(y,NN,n))
+{
+  #pragma scop
+  tile_lu_solve_tasks(n, A, b, x, y);
+  #pragma endscop
+}
+
+
+
+int main(int argc, char** argv)
+{
+  /* Retrieve problem size. */
+  int n = POLYBENCH_NAMED_SIZE("N", NN);
+
+  /* Variable declaration/allocation. */
+  POLYBENCH_2D_ARRAY_DECL(A, DATA_TYPE, NN, NN, n, n);
+  POLYBENCH_1D_ARRAY_DECL(b, DATA_TYPE, NN, n);
+  POLYBENCH_1D_ARRAY_DECL(x, DATA_TYPE, NN, n);
+  POLYBENCH_1D_ARRAY_DECL(y, DATA_TYPE, NN, n);
+  LUDCMP_REFERENCE_DECL (n);
+
+  /* Reserve the scratch storage of the kernel, the pivots, out of the
+     timed region. */
+  polybench_scratch_reserve (sizeof(int[n]) + POLYBENCH_ALIGNMENT);
+
+
+  /* Data kept by the dataset cache, if enabled. */
+  polybench_dataset_array (A);
+  polybench_dataset_array (b);
+  polybench_dataset_array (x);
+  polybench_dataset_array (y);
+
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
+  /* Initialize array(s), unless the dataset cache holds them. */
+  if (! polybench_dataset_load ())
+    {
+      init_array (n,
+		  POLYBENCH_ARRAY(A),
+		  POLYBENCH_ARRAY(b),
+		  POLYBENCH_ARRAY(x),
+		  POLYBENCH_ARRAY(y));
+      polybench_dataset_store ();
+    }
+  LUDCMP_REFERENCE_COPY;
+
+  /* Start timer. */
+  polybench_start_instruments;
+
+  /* Run kernel. */
+  kernel_ludcmp (n,
+		 POLYBENCH_ARRAY(A),
+		 POLYBENCH_ARRAY(b),
+		 POLYBENCH_ARRAY(x),
+		 POLYBENCH_ARRAY(y));
+
+  /* Stop and print timer. */
+  polybench_stop_instruments;
+  polybench_repeat_end;
+  polybench_print_instruments;
+
+  /* Prevent dead-code elimination. All live-out data must be printed
+     by the function call in argument. */
+  polybench_prevent_dce(print_array(n, POLYBENCH_ARRAY(x)));
+
+  /* With -DPOLYBENCH_VERIFY, compare with the reference. */
+  LUDCMP_REFERENCE_CHECK (n);
+
+  /* Be clean. */
+  POLYBENCH_FREE_ARRAY(A);
+  POLYBENCH_FREE_ARRAY(b);
+  POLYBENCH_FREE_ARRAY(x);
+  POLYBENCH_FREE_ARRAY(y);
+  LUDCMP_REFERENCE_FREE;
+  polybench_scratch_free ();
+
+  return polybench_verify_status ();
+}
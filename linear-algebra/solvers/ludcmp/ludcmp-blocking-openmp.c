@@ -13,6 +13,9 @@
 /* Include benchmark-specific header. */
 #include "ludcmp.h"
 
+/* Include the reference implementation, for POLYBENCH_VERIFY. */
+#include "ludcmp-reference.h"
+
 #include <omp.h>
 
 
@@ -27,6 +30,7 @@ void init_array (int n,
   int i, j;
   DATA_TYPE fn = (DATA_TYPE)n;
 
+  polybench_parallel_init (j)
   for (i = 0; i < n; i++)
     {
       x[i] = 0;
@@ -34,6 +38,7 @@ void init_array (int n,
       b[i] = (i+1)/fn/2.0 + 4;
     }
 
+  polybench_parallel_init (j)
   for (i = 0; i < n; i++)
     {
       for (j = 0; j <= i; j++)
@@ -73,6 +78,10 @@ void print_array(int n,
 {
   int i;
 
+#ifdef POLYBENCH_CHECKSUM
+  POLYBENCH_CHECKSUM_1D("x", x, n);
+  return;
+#endif
   POLYBENCH_DUMP_START;
   POLYBENCH_DUMP_BEGIN("x");
   for (i = 0; i < n; i++) {
@@ -84,6 +93,7 @@ void print_array(int n,
 }
 
 
+static
 DATA_TYPE min(DATA_TYPE x, DATA_TYPE y) {
   if (x < y) {
     return x;
@@ -92,9 +102,11 @@ DATA_TYPE min(DATA_TYPE x, DATA_TYPE y) {
   }
 }
 
+static
 void invert_unity_lower_triangular_matrix(int d, DATA_TYPE L[d][d]) {
-    DATA_TYPE b[d][d];
-    memset(b, 0, sizeof(b));
+    unsigned long mark = polybench_scratch_mark();
+    DATA_TYPE (*b)[d] = polybench_scratch_alloc(sizeof(DATA_TYPE[d][d]));
+    memset(b, 0, sizeof(DATA_TYPE[d][d]));
 
     for (int i = 0; i < d; i++) {
         b[i][i] = 1; // diagonal
@@ -132,12 +144,15 @@ void invert_unity_lower_triangular_matrix(int d, DATA_TYPE L[d][d]) {
         }
     }
 
-    memcpy(L, b, sizeof(b));
+    memcpy(L, b, sizeof(DATA_TYPE[d][d]));
+    polybench_scratch_release(mark);
 }
 
+static
 void invert_upper_triangular_matrix(int d, DATA_TYPE U[d][d]) {
-    DATA_TYPE c[d][d];
-    memset(c, 0, sizeof(c));
+    unsigned long mark = polybench_scratch_mark();
+    DATA_TYPE (*c)[d] = polybench_scratch_alloc(sizeof(DATA_TYPE[d][d]));
+    memset(c, 0, sizeof(DATA_TYPE[d][d]));
 
     for (int i = d-1; i >= 0; i--) {
         c[i][i] = 1 / U[i][i]; // diagonal
@@ -180,16 +195,18 @@ void invert_upper_triangular_matrix(int d, DATA_TYPE U[d][d]) {
         }
     }
 
-        memcpy(U, c, sizeof(c));
+        memcpy(U, c, sizeof(DATA_TYPE[d][d]));
+        polybench_scratch_release(mark);
 }
 
 // Equation 4 in the paper linked above
 // LU factorization according to Doolitte's method
+static
 void block_lu_factorization_recursive(
     int n,
     int o, // offset of submatrix (starting index for both x and y)
     int s, // max size of submatrix (exclusive)
-    DATA_TYPE A[n][n],
+    DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
     DATA_TYPE L[n][n],
     DATA_TYPE U[n][n]
 ) {
@@ -198,13 +215,14 @@ void block_lu_factorization_recursive(
     assert(n >= o + s);
 #endif
     // Step 1: Compute l, u
-    DATA_TYPE l[s][s]; // Equivalent to L_11 in paper
-    DATA_TYPE u[s][s]; // Equivalent to U_11 in paper
-    memset(l, 0, sizeof(l));
-    memset(u, 0, sizeof(u));
-
-    DATA_TYPE a[s][s]; 
-    memset(a, 0, sizeof(a));
+    unsigned long mark = polybench_scratch_mark();
+    DATA_TYPE (*l)[s] = polybench_scratch_alloc(sizeof(DATA_TYPE[s][s])); // Equivalent to L_11 in paper
+    DATA_TYPE (*u)[s] = polybench_scratch_alloc(sizeof(DATA_TYPE[s][s])); // Equivalent to U_11 in paper
+    memset(l, 0, sizeof(DATA_TYPE[s][s]));
+    memset(u, 0, sizeof(DATA_TYPE[s][s]));
+
+    DATA_TYPE (*a)[s] = polybench_scratch_alloc(sizeof(DATA_TYPE[s][s]));
+    memset(a, 0, sizeof(DATA_TYPE[s][s]));
     for (int i = 0; i < s; i++) {
         for (int j = 0; j < s; j++) {
             a[i][j] = A[i + o][j + o];
@@ -330,6 +348,8 @@ void block_lu_factorization_recursive(
         }
     }
 
+    polybench_scratch_release(mark);
+
     // Step 4: Recursively compute L_22, U_22
     int next_o = o + s;
     int next_s = min(s, n - next_o);
@@ -340,6 +360,7 @@ void block_lu_factorization_recursive(
 
 // Solves Ax=b for x
 // Modifies A, x, and b.
+static
 void block_lu_factorization(int n,
 		   DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
 		   DATA_TYPE POLYBENCH_1D(b,NN,n),
@@ -348,8 +369,11 @@ void block_lu_factorization(int n,
 ) {
 
     int s = min(16, n);
-    DATA_TYPE (*L)[n] = calloc(n * n, sizeof(DATA_TYPE));
-    DATA_TYPE (*U)[n] = calloc(n * n, sizeof(DATA_TYPE));
+    unsigned long mark = polybench_scratch_mark();
+    DATA_TYPE (*L)[n] = polybench_scratch_alloc(sizeof(DATA_TYPE[n][n]));
+    DATA_TYPE (*U)[n] = polybench_scratch_alloc(sizeof(DATA_TYPE[n][n]));
+    memset(L, 0, sizeof(DATA_TYPE[n][n]));
+    memset(U, 0, sizeof(DATA_TYPE[n][n]));
 
     block_lu_factorization_recursive(n, 0, s, A, L, U);
 
@@ -387,8 +411,7 @@ void block_lu_factorization(int n,
         #endif
     }
 
-    free(L);
-    free(U);
+    polybench_scratch_release(mark);
 }
 
 
@@ -412,24 +435,46 @@ void kernel_ludcmp(int n,
 }
 
 
+
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = NN;
+  int n = POLYBENCH_NAMED_SIZE("N", NN);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(A, DATA_TYPE, NN, NN, n, n);
   POLYBENCH_1D_ARRAY_DECL(b, DATA_TYPE, NN, n);
   POLYBENCH_1D_ARRAY_DECL(x, DATA_TYPE, NN, n);
   POLYBENCH_1D_ARRAY_DECL(y, DATA_TYPE, NN, n);
+  LUDCMP_REFERENCE_DECL (n);
+
+  /* Reserve the scratch storage of the kernel, L, U and the diagonal
+     blocks, out of the timed region. */
+  polybench_scratch_reserve (2 * sizeof(DATA_TYPE[n][n])
+			     + 4 * sizeof(DATA_TYPE[16][16])
+			     + 2 * POLYBENCH_ALIGNMENT);
+
 
+  /* Data kept by the dataset cache, if enabled. */
+  polybench_dataset_array (A);
+  polybench_dataset_array (b);
+  polybench_dataset_array (x);
+  polybench_dataset_array (y);
 
-  /* Initialize array(s). */
-  init_array (n,
-	      POLYBENCH_ARRAY(A),
-	      POLYBENCH_ARRAY(b),
-	      POLYBENCH_ARRAY(x),
-	      POLYBENCH_ARRAY(y));
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
+  /* Initialize array(s), unless the dataset cache holds them. */
+  if (! polybench_dataset_load ())
+    {
+      init_array (n,
+		  POLYBENCH_ARRAY(A),
+		  POLYBENCH_ARRAY(b),
+		  POLYBENCH_ARRAY(x),
+		  POLYBENCH_ARRAY(y));
+      polybench_dataset_store ();
+    }
+  LUDCMP_REFERENCE_COPY;
 
   /* Start timer. */
   polybench_start_instruments;
@@ -443,17 +488,23 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
      by the function call in argument. */
   polybench_prevent_dce(print_array(n, POLYBENCH_ARRAY(x)));
 
+  /* With -DPOLYBENCH_VERIFY, compare with the reference. */
+  LUDCMP_REFERENCE_CHECK (n);
+
   /* Be clean. */
   POLYBENCH_FREE_ARRAY(A);
   POLYBENCH_FREE_ARRAY(b);
   POLYBENCH_FREE_ARRAY(x);
   POLYBENCH_FREE_ARRAY(y);
+  LUDCMP_REFERENCE_FREE;
+  polybench_scratch_free ();
 
-  return 0;
+  return polybench_verify_status ();
 }
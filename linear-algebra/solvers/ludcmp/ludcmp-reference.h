@@ -0,0 +1,104 @@
+/**
+ * This version is stamped on May 10, 2016
+ *
+ * Contact:
+ *   Louis-Noel Pouchet <pouchet.ohio-state.edu>
+ *   Tomofumi Yuki <tomofumi.yuki.fr>
+ *
+ * Web address: http://polybench.sourceforge.net
+ */
+/* ludcmp-reference.h: this file is part of PolyBench/C */
+#ifndef _LUDCMP_REFERENCE_H
+#define _LUDCMP_REFERENCE_H
+
+/* With -DPOLYBENCH_VERIFY, the variants of ludcmp check their solution
+   against the loop nest of ludcmp.c, run on a copy of the inputs. Their
+   main brackets its steps with the macros below, which use the arrays
+   A, b, x and y of main and expand to nothing without POLYBENCH_VERIFY:
+
+     LUDCMP_REFERENCE_DECL (n);   after the declaration of the arrays
+     LUDCMP_REFERENCE_COPY;       after the initialization, untimed
+     LUDCMP_REFERENCE_CHECK (n);  after print_array
+     LUDCMP_REFERENCE_FREE;       with the other POLYBENCH_FREE_ARRAY
+*/
+
+#ifdef POLYBENCH_VERIFY
+/* Reference implementation of ludcmp.c. */
+static
+void kernel_ludcmp_reference(int n,
+			     DATA_TYPE POLYBENCH_2D(A,NN,NN,n,n),
+			     DATA_TYPE POLYBENCH_1D(b,NN,n),
+			     DATA_TYPE POLYBENCH_1D(x,NN,n),
+			     DATA_TYPE POLYBENCH_1D(y,NN,n))
+{
+  int i, j, k;
+
+  DATA_TYPE w;
+
+  for (i = 0; i < _PB_N; i++) {
+    for (j = 0; j <i; j++) {
+       w = A[i][j];
+       for (k = 0; k < j; k++) {
+          w -= A[i][k] * A[k][j];
+       }
+        A[i][j] = w / A[j][j];
+    }
+   for (j = i; j < _PB_N; j++) {
+       w = A[i][j];
+       for (k = 0; k < i; k++) {
+          w -= A[i][k] * A[k][j];
+       }
+       A[i][j] = w;
+    }
+  }
+
+  for (i = 0; i < _PB_N; i++) {
+     w = b[i];
+     for (j = 0; j < i; j++)
+        w -= A[i][j] * y[j];
+     y[i] = w;
+  }
+
+   for (i = _PB_N-1; i >=0; i--) {
+     w = y[i];
+     for (j = i+1; j < _PB_N; j++)
+        w -= A[i][j] * x[j];
+     x[i] = w / A[i][i];
+  }
+}
+
+/* Copy of the inputs of the last run, for the reference. */
+# define LUDCMP_REFERENCE_DECL(n)					\
+  POLYBENCH_2D_ARRAY_DECL(A_ref, DATA_TYPE, NN, NN, n, n);		\
+  POLYBENCH_1D_ARRAY_DECL(b_ref, DATA_TYPE, NN, n);			\
+  POLYBENCH_1D_ARRAY_DECL(x_ref, DATA_TYPE, NN, n);			\
+  POLYBENCH_1D_ARRAY_DECL(y_ref, DATA_TYPE, NN, n)
+# define LUDCMP_REFERENCE_COPY					\
+  POLYBENCH_COPY_ARRAY(A_ref, A);					\
+  POLYBENCH_COPY_ARRAY(b_ref, b);					\
+  POLYBENCH_COPY_ARRAY(x_ref, x);					\
+  POLYBENCH_COPY_ARRAY(y_ref, y)
+/* Check the backward error of the solution, then compare it with the
+   reference implementation run on the same inputs. */
+# define LUDCMP_REFERENCE_CHECK(n)					\
+  POLYBENCH_VERIFY_RESIDUAL("x", POLYBENCH_ARRAY(A_ref),		\
+			    POLYBENCH_ARRAY(x), POLYBENCH_ARRAY(b_ref), n); \
+  kernel_ludcmp_reference (n,						\
+			   POLYBENCH_ARRAY(A_ref),			\
+			   POLYBENCH_ARRAY(b_ref),			\
+			   POLYBENCH_ARRAY(x_ref),			\
+			   POLYBENCH_ARRAY(y_ref));			\
+  POLYBENCH_VERIFY_1D("x", POLYBENCH_ARRAY(x), POLYBENCH_ARRAY(x_ref), n)
+# define LUDCMP_REFERENCE_FREE					\
+  POLYBENCH_FREE_ARRAY(A_ref);						\
+  POLYBENCH_FREE_ARRAY(b_ref);						\
+  POLYBENCH_FREE_ARRAY(x_ref);						\
+  POLYBENCH_FREE_ARRAY(y_ref)
+#else
+# define LUDCMP_REFERENCE_DECL(n)
+# define LUDCMP_REFERENCE_COPY
+# define LUDCMP_REFERENCE_CHECK(n)
+# define LUDCMP_REFERENCE_FREE
+#endif
+
+#endif /* !_LUDCMP_REFERENCE_H */
@@ -25,6 +25,21 @@
 
 #define _PB_N POLYBENCH_LOOP_BOUND(NN, n)
 
+/* Analytic model, see utilities/polybench.spec: number of floating
+   point operations, and minimal memory traffic in array elements.
+   POLYBENCH_PROGRAM_SIZES lists the name and value of each parameter. */
+#define POLYBENCH_PROGRAM_FLOPS (1.0*(_PB_N)*(_PB_N)*((_PB_N)-1) - 1.0*(_PB_N)*((_PB_N)-1)*(2*(_PB_N)-1)/6.0 + 2.0*(_PB_N)*((_PB_N)-1) + (_PB_N))
+#define POLYBENCH_PROGRAM_WORDS (2.0*(_PB_N)*(_PB_N) + 2.0*(_PB_N))
+#define POLYBENCH_PROGRAM_SIZES "N", _PB_N
+/* Name of the kernel, the directory of its variants. */
+#define POLYBENCH_KERNEL_NAME "ludcmp"
+
+/* Tolerance of POLYBENCH_VERIFY, in machine epsilons: the variants
+   factor A in another order, with LAPACK or with partial pivoting. */
+#ifndef POLYBENCH_VERIFY_TOLERANCE
+#define POLYBENCH_VERIFY_TOLERANCE 1000
+#endif
+
 /* Default data type */
 #if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) && !defined(DATA_TYPE_IS_DOUBLE)
 #define DATA_TYPE_IS_DOUBLE
@@ -158,8 +158,8 @@ void kernel_deriche(int w, int h, DATA_TYPE alpha,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int w = W;
-  int h = H;
+  int w = POLYBENCH_SIZE(W);
+  int h = POLYBENCH_SIZE(H);
 
   /* Variable declaration/allocation. */
   DATA_TYPE alpha;
@@ -169,6 +169,9 @@ int main(int argc, char** argv)
   POLYBENCH_2D_ARRAY_DECL(y2, DATA_TYPE, W, H, w, h);
 
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (w, h, &alpha, POLYBENCH_ARRAY(imgIn), POLYBENCH_ARRAY(imgOut));
 
@@ -180,6 +183,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
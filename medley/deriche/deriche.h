@@ -49,6 +49,15 @@
 # define _PB_H POLYBENCH_LOOP_BOUND(H,h)
 
 
+/* Analytic model, see utilities/polybench.spec: number of floating
+   point operations, and minimal memory traffic in array elements.
+   POLYBENCH_PROGRAM_SIZES lists the name and value of each parameter. */
+# define POLYBENCH_PROGRAM_FLOPS (32.0*(_PB_W)*(_PB_H))
+# define POLYBENCH_PROGRAM_WORDS (2.0*(_PB_W)*(_PB_H))
+# define POLYBENCH_PROGRAM_SIZES "W", _PB_W, "H", _PB_H
+/* Name of the kernel, the directory of its variants. */
+# define POLYBENCH_KERNEL_NAME "deriche"
+
 /* Default data type */
 # if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) && !defined(DATA_TYPE_IS_DOUBLE)
 #  define DATA_TYPE_IS_FLOAT
@@ -1,7 +1,13 @@
 import os
+import re
 from helper import get_files
 import sys
 
+# Compare the fingerprints printed with -DPOLYBENCH_CHECKSUM rather than
+# the arrays dumped with -DPOLYBENCH_DUMP_ARRAYS.
+USE_CHECKSUM = True
+CHECKSUM_TOLERANCE = 1e-6
+
 def main():
     check_benches("./linear-algebra/solvers/ludcmp")
 
@@ -52,8 +58,10 @@ def run_impl(impl):
 
     joined_flags = " ".join(flags)
 
+    mode = "-DPOLYBENCH_CHECKSUM" if USE_CHECKSUM else "-DPOLYBENCH_DUMP_ARRAYS"
+
     # Compile implementation
-    os.system(f"{compiler} {joined_flags} -I utilities -I {header} utilities/polybench.c {impl} -DPOLYBENCH_DUMP_ARRAYS -o executable")
+    os.system(f"{compiler} {joined_flags} -I utilities -I {header} utilities/polybench.c {impl} {mode} -lm -o executable")
     # Run and get output
     if "mpi" in impl:
         np = 2#sys.argv[1]
@@ -67,10 +75,49 @@ def run_impl(impl):
         print(output)
         printRed("-"*30)
 
+    if USE_CHECKSUM:
+        return parse_checksums(output)
+
     digits = [float(x) for x in output.split() if isfloat(x)]
     return digits
 
 
+def parse_checksums(output):
+    checksums = {}
+    for line in output.splitlines():
+        match = re.match(r"checksum: (\S+) (.*)", line)
+        if match:
+            fields = dict(f.split("=") for f in match.group(2).split())
+            checksums[match.group(1)] = fields
+    return checksums
+
+
+def close(x1, x2, scale):
+    return abs(x1 - x2) <= CHECKSUM_TOLERANCE * scale
+
+
+def same_checksums(sums1, sums2):
+    if sums1.keys() != sums2.keys() or not sums1:
+        printRed("Array mismatch: {} vs {}".format(list(sums1), list(sums2)))
+        return False
+
+    for name, c1 in sums1.items():
+        c2 = sums2[name]
+        n = int(c1["elements"])
+        l2 = float(c1["l2"])
+        if (c1["elements"] != c2["elements"]
+                or not close(float(c1["l2"]), float(c2["l2"]), l2)
+                or not close(float(c1["max"]), float(c2["max"]), float(c1["max"]))
+                # |sum| <= sqrt(n) * l2
+                or not close(float(c1["sum"]), float(c2["sum"]), n ** 0.5 * l2)):
+            print("{}: {} vs {}".format(name, c1, c2))
+            return False
+        if c1["hash"] != c2["hash"]:
+            print("{}: hashes differ, values on a rounding boundary".format(name))
+
+    return True
+
+
 def isfloat(num):
     try:
         float(num)
@@ -80,6 +127,9 @@ def isfloat(num):
 
 
 def same_arrays(arr1, arr2):
+    if isinstance(arr1, dict):
+        return same_checksums(arr1, arr2)
+
     if len(arr1) != len(arr2):
         print("arr1", arr1)
         print("arr2", arr2)
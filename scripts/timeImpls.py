@@ -21,6 +21,15 @@ def time_bench(dataset_sizes, dir):
     base = files["base"]
     optimizations = files["opt"]
 
+    # One executable per implementation, the sizes are given at run time
+    for other_impl in optimizations:
+        compile_impl(other_impl)
+
+    # The LAPACK implementation (getrf/getrs) runs first on each size, and
+    # the others are compared with it on the same inputs
+    lapack = [impl for impl in optimizations if "blas" in impl]
+    optimizations = lapack + [impl for impl in optimizations if impl not in lapack]
+
     for dataset_size in dataset_sizes:
         #print(f"Running for dataset size {dataset_size}")
 
@@ -28,9 +37,12 @@ def time_bench(dataset_sizes, dir):
         #base_result = run_impl(base, dataset_size)
         #print("{} seconds".format(base_result))
 
+        lapack_runtime = None
         for other_impl in optimizations:
             print("{}".format(os.path.basename(other_impl)), end =" ... ", flush=True)
-            other_result = run_impl(other_impl, dataset_size)
+            other_result = run_impl(other_impl, dataset_size, lapack_runtime=lapack_runtime)
+            if other_impl in lapack:
+                lapack_runtime = min(result["runtime"] for result in other_result)
 
             #percentage_improvement = round((other_result - base_result) / base_result * 100)
             #speedup = round(base_result / other_result)
@@ -44,7 +56,11 @@ def time_bench(dataset_sizes, dir):
             #     print(msg)
 
 
-def run_impl(impl:str, dataset_size, runs = 1):
+def executable(impl:str):
+    return "./" + os.path.basename(impl).replace(".c", "")
+
+
+def compile_impl(impl:str):
     header = impl.replace(".c", "")
 
     if "mpi" in impl:
@@ -67,8 +83,11 @@ def run_impl(impl:str, dataset_size, runs = 1):
 
     # Compile implementation
     if impl.endswith(".c"):
-        os.system(f"{compiler} {joined_flags} -I utilities -I {header} utilities/polybench.c {impl} -DSIZE_DATASET={dataset_size} -DPOLYBENCH_TIME -o executable")
-    
+        os.system(f"{compiler} {joined_flags} -I utilities -I {header} utilities/polybench.c {impl} -DPOLYBENCH_RUNTIME_SIZES -DPOLYBENCH_TIME -o {executable(impl)}")
+
+
+def run_impl(impl:str, dataset_size, runs = 1, lapack_runtime = None):
+    header = impl.replace(".c", "")
     outputs = []
     key = "OMP_NUM_THREADS"
     numc_cores = os.getenv(key, "X")
@@ -77,9 +96,9 @@ def run_impl(impl:str, dataset_size, runs = 1):
     for _ in range(runs):
         if "mpi" in impl:
             np = 2
-            output = os.popen(f"mpirun -np {np} --oversubscribe ./executable 2>&1").read()
+            output = os.popen(f"mpirun -np {np} --oversubscribe {executable(impl)} N={dataset_size} 2>&1").read()
         else:
-            output = os.popen("./executable 2>&1").read()
+            output = os.popen(f"{executable(impl)} N={dataset_size} 2>&1").read()
         results = {
             "name": os.path.basename(header),
             "runtime": float(output),
@@ -87,6 +106,8 @@ def run_impl(impl:str, dataset_size, runs = 1):
             "n_processors": numc_cores,
             "nodes": np,
         }
+        if lapack_runtime is not None:
+            results["speedup_vs_lapack"] = round(lapack_runtime / results["runtime"], 3)
         print(results)
         outputs.append(results)
     return outputs
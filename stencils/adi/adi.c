@@ -131,8 +131,8 @@ void kernel_adi(int tsteps, int n,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
-  int tsteps = TSTEPS;
+  int n = POLYBENCH_SIZE(N);
+  int tsteps = POLYBENCH_SIZE(TSTEPS);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(u, DATA_TYPE, N, N, n, n);
@@ -141,6 +141,9 @@ int main(int argc, char** argv)
   POLYBENCH_2D_ARRAY_DECL(q, DATA_TYPE, N, N, n, n);
 
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (n, POLYBENCH_ARRAY(u));
 
@@ -152,6 +155,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
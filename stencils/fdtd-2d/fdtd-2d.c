@@ -122,9 +122,9 @@ void kernel_fdtd_2d(int tmax,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int tmax = TMAX;
-  int nx = NX;
-  int ny = NY;
+  int tmax = POLYBENCH_SIZE(TMAX);
+  int nx = POLYBENCH_SIZE(NX);
+  int ny = POLYBENCH_SIZE(NY);
 
   /* Variable declaration/allocation. */
   POLYBENCH_2D_ARRAY_DECL(ex,DATA_TYPE,NX,NY,nx,ny);
@@ -132,6 +132,9 @@ int main(int argc, char** argv)
   POLYBENCH_2D_ARRAY_DECL(hz,DATA_TYPE,NX,NY,nx,ny);
   POLYBENCH_1D_ARRAY_DECL(_fict_,DATA_TYPE,TMAX,tmax);
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (tmax, nx, ny,
 	      POLYBENCH_ARRAY(ex),
@@ -152,6 +155,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
@@ -55,6 +55,15 @@
 # define _PB_NY POLYBENCH_LOOP_BOUND(NY,ny)
 
 
+/* Analytic model, see utilities/polybench.spec: number of floating
+   point operations, and minimal memory traffic in array elements.
+   POLYBENCH_PROGRAM_SIZES lists the name and value of each parameter. */
+# define POLYBENCH_PROGRAM_FLOPS ((_PB_TMAX)*(3.0*((_PB_NX)-1)*(_PB_NY) + 3.0*(_PB_NX)*((_PB_NY)-1) + 5.0*((_PB_NX)-1)*((_PB_NY)-1)))
+# define POLYBENCH_PROGRAM_WORDS (6.0*(_PB_NX)*(_PB_NY) + (_PB_TMAX))
+# define POLYBENCH_PROGRAM_SIZES "TMAX", _PB_TMAX, "NX", _PB_NX, "NY", _PB_NY
+/* Name of the kernel, the directory of its variants. */
+# define POLYBENCH_KERNEL_NAME "fdtd-2d"
+
 /* Default data type */
 # if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) && !defined(DATA_TYPE_IS_DOUBLE)
 #  define DATA_TYPE_IS_DOUBLE
@@ -69,7 +69,7 @@ void kernel_heat_3d(int tsteps,
   int t, i, j, k;
 
 #pragma scop
-    for (t = 1; t <= TSTEPS; t++) {
+    for (t = 1; t <= _PB_TSTEPS; t++) {
         for (i = 1; i < _PB_N-1; i++) {
             for (j = 1; j < _PB_N-1; j++) {
                 for (k = 1; k < _PB_N-1; k++) {
@@ -99,14 +99,17 @@ void kernel_heat_3d(int tsteps,
 int main(int argc, char** argv)
 {
   /* Retrieve problem size. */
-  int n = N;
-  int tsteps = TSTEPS;
+  int n = POLYBENCH_SIZE(N);
+  int tsteps = POLYBENCH_SIZE(TSTEPS);
 
   /* Variable declaration/allocation. */
   POLYBENCH_3D_ARRAY_DECL(A, DATA_TYPE, N, N, N, n, n, n);
   POLYBENCH_3D_ARRAY_DECL(B, DATA_TYPE, N, N, N, n, n, n);
 
 
+  /* Repeat initialization and kernel execution, if requested. */
+  polybench_repeat_begin;
+
   /* Initialize array(s). */
   init_array (n, POLYBENCH_ARRAY(A), POLYBENCH_ARRAY(B));
 
@@ -118,6 +121,7 @@ int main(int argc, char** argv)
 
   /* Stop and print timer. */
   polybench_stop_instruments;
+  polybench_repeat_end;
   polybench_print_instruments;
 
   /* Prevent dead-code elimination. All live-out data must be printed
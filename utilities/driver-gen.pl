@@ -0,0 +1,139 @@
+#!/usr/bin/perl
+
+# Generates the build of the multi-kernel driver (polybench-driver.c):
+# the registry of the kernels and variants, polybench_kernels.h, and a
+# Makefile which links them all into one executable, polybench.
+# Expects to be executed from root folder of polybench
+#
+# MPI variants, which need mpirun, are not part of the driver; the
+# BLAS and MKL variants are added with -blas and -mkl, and the AVX-512
+# variants with -avx512.
+#
+
+use Cwd 'abs_path';
+
+my $TARGET_DIR = "";
+my %OPTIONS = ('blas' => 0, 'mkl' => 0, 'avx512' => 0);
+
+foreach my $arg (@ARGV) {
+   if ($arg =~ /^-(blas|mkl|avx512)$/) {
+      $OPTIONS{$1} = 1;
+   } elsif (!($arg =~ /^-/)) {
+      $TARGET_DIR = $arg;
+   }
+}
+
+if ($TARGET_DIR eq '') {
+   printf("usage perl driver-gen.pl output-dir [-blas] [-mkl] [-avx512]\n");
+   exit(1);
+}
+
+my @categories = ('linear-algebra/blas',
+                  'linear-algebra/kernels',
+                  'linear-algebra/solvers',
+                  'datamining',
+                  'stencils',
+                  'medley');
+
+my $root = abs_path('.');
+my $utilityDir = $root.'/utilities';
+my @kernels = ();
+my $libs = '-lm';
+
+foreach $cat (@categories) {
+   my $target = $root.'/'.$cat;
+   opendir DIR, $target or die "directory $target not found.\n";
+   foreach my $dir (sort readdir DIR) {
+        next if ($dir=~'^\..*');
+        next if (!(-d $target.'/'.$dir));
+
+        my $kernelDir = $target.'/'.$dir;
+        opendir KDIR, $kernelDir or die "directory $kernelDir not found.\n";
+        # The kernel first, then its variants.
+        my @files = sort { ($a ne "$dir.c") <=> ($b ne "$dir.c") or $a cmp $b }
+           grep { /^\Q$dir\E(-[A-Za-z0-9-]+)?\.c$/ } readdir KDIR;
+        closedir KDIR;
+
+        foreach my $file (@files) {
+           my $variant = $file;
+           $variant =~ s/^\Q$dir\E-?//;
+           $variant =~ s/\.c$//;
+           next if ($variant =~ /mpi/);
+           next if ($variant =~ /blas/ && !$OPTIONS{'blas'});
+           next if ($variant =~ /mkl/ && !$OPTIONS{'mkl'});
+
+           # Flags from the contents of the file.
+           open SRC, "$kernelDir/$file" or die "failed to open $file.";
+           my $src = join('', <SRC>);
+           close SRC;
+           my $flags = '';
+           $flags .= ' -fopenmp' if ($src =~ /#pragma omp/);
+           $flags .= ' -mavx2 -mfma' if ($src =~ /_mm256_/);
+           if ($src =~ /_mm512_/) {
+              next if (!$OPTIONS{'avx512'});
+              $flags .= ' -mavx512f';
+           }
+           $libs .= ' -lopenblas' if ($src =~ /<cblas.h>/ && !($libs =~ /openblas/));
+           $libs .= ' -llapacke' if ($src =~ /<lapacke.h>/ && !($libs =~ /lapacke/));
+           $libs .= ' ${MKL_LIBS}' if ($src =~ /[<"]mkl\.h/ && !($libs =~ /MKL/));
+
+           my $name = $variant eq '' ? $dir : "$dir/$variant";
+           my $id = $name;
+           $id =~ s/[^A-Za-z0-9]/_/g;
+           push @kernels, [$id, $name, "$kernelDir/$file", "$kernelDir/$dir.h", $flags];
+        }
+   }
+   closedir DIR;
+}
+
+open FILE, ">$TARGET_DIR/polybench_kernels.h" or die "failed to open $TARGET_DIR/polybench_kernels.h.";
+print FILE "/* Generated by utilities/driver-gen.pl: POLYBENCH_KERNEL(id, name) */\n";
+foreach my $k (@kernels) {
+   print FILE "POLYBENCH_KERNEL($k->[0], \"$k->[1]\")\n";
+}
+close FILE;
+
+my $objs = join(' ', map { "$_->[0].o" } @kernels);
+
+open FILE, ">$TARGET_DIR/Makefile" or die "failed to open $TARGET_DIR/Makefile.";
+
+print FILE << "EOF";
+# Generated by utilities/driver-gen.pl
+CC=gcc
+CFLAGS=-O3 -march=native
+POLYBENCH_FLAGS=-DPOLYBENCH_TIME
+MKL_LIBS=-L\${MKLROOT}/lib/intel64 -Wl,--no-as-needed -lmkl_intel_lp64 -lmkl_gnu_thread -lmkl_core -lpthread -ldl
+
+UTILITY_DIR=$utilityDir
+DRIVER_FLAGS=\${CFLAGS} \${POLYBENCH_FLAGS} -DPOLYBENCH_DRIVER -I. -I\${UTILITY_DIR}
+OBJS=$objs
+
+polybench: \${OBJS} polybench.o polybench-driver.o
+	\${VERBOSE} \${CC} -o polybench \${OBJS} polybench.o polybench-driver.o \${CFLAGS} -fopenmp $libs
+
+polybench.o: \${UTILITY_DIR}/polybench.c \${UTILITY_DIR}/polybench.h
+	\${VERBOSE} \${CC} -c -o polybench.o \${UTILITY_DIR}/polybench.c \${DRIVER_FLAGS} -fopenmp
+
+polybench-driver.o: \${UTILITY_DIR}/polybench-driver.c \${UTILITY_DIR}/polybench.h polybench_kernels.h
+	\${VERBOSE} \${CC} -c -o polybench-driver.o \${UTILITY_DIR}/polybench-driver.c \${DRIVER_FLAGS}
+
+EOF
+
+foreach my $k (@kernels) {
+   my ($id, $name, $file, $header, $flags) = @$k;
+   my $dir = $file;
+   $dir =~ s/\/[^\/]*$//;
+print FILE << "EOF";
+$id.o: $file $header \${UTILITY_DIR}/polybench.h
+	\${VERBOSE} \${CC} -c -o $id.o $file \${DRIVER_FLAGS} -I$dir -DPOLYBENCH_KERNEL_ID=$id$flags
+
+EOF
+}
+
+print FILE << "EOF";
+clean:
+	@ rm -f polybench *.o
+
+EOF
+
+close FILE;
@@ -85,6 +85,25 @@ sub generateHeader() {
       }
    }
 
+   my $modelDef = '';
+   if (defined $INPUT{'flops'}[$row]) {
+      my $flops = $INPUT{'flops'}[$row];
+      my $words = $INPUT{'words'}[$row];
+      foreach (@params) {
+         $flops =~ s/\b$_\b/(_PB_$_)/g;
+         $words =~ s/\b$_\b/(_PB_$_)/g;
+      }
+      $modelDef = "/* Analytic model, see utilities/polybench.spec: number of floating\n"
+         ."   point operations, and minimal memory traffic in array elements.\n"
+         ."   POLYBENCH_PROGRAM_SIZES lists the name and value of each parameter. */\n"
+         ."# define POLYBENCH_PROGRAM_FLOPS ($flops)\n"
+         ."# define POLYBENCH_PROGRAM_WORDS ($words)\n";
+   }
+   $modelDef .= '# define POLYBENCH_PROGRAM_SIZES '
+      .join(', ', map { "\"$_\", _PB_$_" } @params)."\n";
+   $modelDef .= "/* Name of the kernel, the directory of its variants. */\n"
+      ."# define POLYBENCH_KERNEL_NAME \"$name\"\n";
+
    my $kernelPath = "$OUTDIR/$category/$name";
    if (!(-e $kernelPath)) {
        mkpath $kernelPath;
@@ -107,6 +126,7 @@ $paramDefs
 
 $loopBoundDef
 
+$modelDef
 /* Default data type */
 # if !defined(DATA_TYPE_IS_INT) && !defined(DATA_TYPE_IS_FLOAT) && !defined(DATA_TYPE_IS_DOUBLE)
 #  define DATA_TYPE_IS_$datatypeUC
@@ -0,0 +1,166 @@
+/**
+ * This version is stamped on May 10, 2016
+ *
+ * Contact:
+ *   Louis-Noel Pouchet <pouchet.ohio-state.edu>
+ *   Tomofumi Yuki <tomofumi.yuki.fr>
+ *
+ * Web address: http://polybench.sourceforge.net
+ */
+/* polybench-driver.c: this file is part of PolyBench/C */
+
+/*
+ * Multi-kernel driver. All the kernels and variants listed in
+ * polybench_kernels.h, generated with utilities/driver-gen.pl, are
+ * linked into one executable with polybench.c, and are selected by
+ * name:
+ *
+ *   polybench list [pattern...]
+ *   polybench run pattern... [--size value]... [SIZE=value]...
+ *
+ * e.g. polybench run ludcmp/blocking-openmp-fma --n 4096. A kernel is
+ * named after its directory, and a variant after its file, e.g.
+ * ludcmp/blocking-openmp-fma for ludcmp-blocking-openmp-fma.c, and
+ * the patterns are shell patterns, e.g. 'ludcmp*' for ludcmp and all
+ * its variants.
+ * The sizes are passed to every selected kernel, as NAME=value (the
+ * option --n 4096 is N=4096), and a kernel ignores the sizes it does
+ * not have. The kernels run one after the other in the same process,
+ * and the exit status is that of the last failing kernel.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <fnmatch.h>
+
+#include "polybench.h"
+
+#ifndef POLYBENCH_DRIVER
+# error "polybench-driver.c must be compiled with -DPOLYBENCH_DRIVER"
+#endif
+
+/* Maximal number of sizes on the command line. */
+#define POLYBENCH_DRIVER_MAX_ARGS 64
+
+#define POLYBENCH_KERNEL(id, name)		\
+  extern int polybench_main_##id(int argc, char** argv);
+#include "polybench_kernels.h"
+#undef POLYBENCH_KERNEL
+
+struct polybench_kernel
+{
+  const char* name;
+  int (*main)(int argc, char** argv);
+};
+
+static const struct polybench_kernel polybench_kernels[] =
+  {
+#define POLYBENCH_KERNEL(id, name) { name, polybench_main_##id },
+#include "polybench_kernels.h"
+#undef POLYBENCH_KERNEL
+    { NULL, NULL }
+  };
+
+
+static
+void usage(const char* prog)
+{
+  fprintf (stderr, "usage: %s list [pattern...]\n"
+	   "       %s run pattern... [--size value]... [SIZE=value]...\n",
+	   prog, prog);
+  exit (1);
+}
+
+
+static
+int matches(const char* name, int nb_patterns, char** patterns)
+{
+  int i;
+
+  if (nb_patterns == 0)
+    return 1;
+  for (i = 0; i < nb_patterns; i++)
+    if (! fnmatch (patterns[i], name, 0))
+      return 1;
+  return 0;
+}
+
+
+int main(int argc, char** argv)
+{
+  char* patterns[POLYBENCH_DRIVER_MAX_ARGS];
+  char* args[POLYBENCH_DRIVER_MAX_ARGS + 2];
+  int nb_patterns = 0, nb_args = 1, nb_run = 0, status = 0;
+  int run, i, k;
+
+  if (argc < 2)
+    usage (argv[0]);
+  if (! strcmp (argv[1], "list"))
+    run = 0;
+  else if (! strcmp (argv[1], "run"))
+    run = 1;
+  else
+    usage (argv[0]);
+
+  /* Split the patterns and the sizes, which are rewritten as NAME=value
+     for polybench_runtime_size. */
+  for (i = 2; i < argc; i++)
+    {
+      if (nb_patterns == POLYBENCH_DRIVER_MAX_ARGS
+	  || nb_args > POLYBENCH_DRIVER_MAX_ARGS)
+	usage (argv[0]);
+      if (! strncmp (argv[i], "--", 2) && argv[i][2] != '\0')
+	{
+	  char* size;
+	  if (i + 1 == argc)
+	    usage (argv[0]);
+	  size = malloc (strlen (argv[i]) + strlen (argv[i + 1]));
+	  for (k = 0; argv[i][k + 2] != '\0'; k++)
+	    size[k] = toupper ((unsigned char) argv[i][k + 2]);
+	  sprintf (size + k, "=%s", argv[++i]);
+	  args[nb_args++] = size;
+	}
+      else if (strchr (argv[i], '=') != NULL)
+	args[nb_args++] = argv[i];
+      else
+	patterns[nb_patterns++] = argv[i];
+    }
+  args[nb_args] = NULL;
+  if (run && nb_patterns == 0)
+    usage (argv[0]);
+
+  for (k = 0; polybench_kernels[k].name != NULL; k++)
+    {
+      if (! matches (polybench_kernels[k].name, nb_patterns, patterns))
+	continue;
+      nb_run++;
+      if (! run)
+	{
+	  printf ("%s\n", polybench_kernels[k].name);
+	  continue;
+	}
+      printf ("[PolyBench] kernel %s\n", polybench_kernels[k].name);
+      fflush (stdout);
+      polybench_program_reset ();
+      args[0] = (char*) polybench_kernels[k].name;
+      if ((i = polybench_kernels[k].main (nb_args, args)) != 0)
+	{
+	  fprintf (stderr, "[PolyBench] kernel %s failed (%d)\n",
+		   polybench_kernels[k].name, i);
+	  status = i;
+	}
+      fflush (stdout);
+    }
+  if (run)
+    polybench_program_reset ();
+
+  if (nb_run == 0)
+    {
+      fprintf (stderr, "[PolyBench] no kernel matches\n");
+      return 1;
+    }
+
+  return status;
+}
@@ -9,6 +9,12 @@
  */
 /* polybench.c: this file is part of PolyBench/C */
 
+/* Needed for clock_gettime and the Linux-specific interfaces below,
+   even when compiling with -std=c99. */
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -19,6 +25,9 @@
 #include <sys/resource.h>
 #include <sched.h>
 #include <math.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 #ifdef _OPENMP
 # include <omp.h>
 #endif
@@ -36,14 +45,57 @@
 # define POLYBENCH_THREAD_MONITOR 0
 #endif
 
-/* Total LLC cache size. By default 32+MB.. */
-#ifndef POLYBENCH_CACHE_SIZE_KB
-# define POLYBENCH_CACHE_SIZE_KB 32770
+/* With POLYBENCH_MONITOR_ALL_THREADS, counters are collected on every
+   OpenMP thread instead of the single POLYBENCH_THREAD_MONITOR thread. */
+#if defined(POLYBENCH_MONITOR_ALL_THREADS) && defined(_OPENMP)
+# define POLYBENCH_MULTI_THREAD_MONITOR
+#endif
+#ifndef POLYBENCH_MAX_NB_THREADS
+# define POLYBENCH_MAX_NB_THREADS 256
+#endif
+#ifdef POLYBENCH_MULTI_THREAD_MONITOR
+# define POLYBENCH_NB_MONITOR_SLOTS POLYBENCH_MAX_NB_THREADS
+#else
+# define POLYBENCH_NB_MONITOR_SLOTS 1
+#endif
+
+/* Size of the cache flush buffer, as a multiple of the aggregate
+   capacity of the data caches of the machine. POLYBENCH_CACHE_SIZE_KB,
+   if defined, sets the size of the buffer instead. */
+#ifndef POLYBENCH_FLUSH_FACTOR
+# define POLYBENCH_FLUSH_FACTOR 2
 #endif
+/* Capacity assumed when it cannot be read from the system: 32+MB. */
+#define POLYBENCH_DEFAULT_CACHE_SIZE_KB 32770
+
 
+#ifdef POLYBENCH_RECORD
+static void polybench_write_record(char** counter_names,
+				   const long long* counters, int nb_counters);
+#endif
+#ifdef POLYBENCH_NUMA
+static void polybench_print_numa_placement();
+#endif
+#if defined(POLYBENCH_AFFINITY) || defined(POLYBENCH_RECORD)
+static void polybench_sample_thread_cpus();
+#endif
+#ifdef POLYBENCH_AFFINITY
+static void polybench_affinity_apply();
+static void polybench_print_thread_cpus();
+static const char* polybench_affinity_policy;
+#endif
+#ifdef POLYBENCH_MEMORY_REPORT
+static void polybench_print_memory();
+static long polybench_peak_rss();
+static long polybench_memory_scratch_peak;
+static long polybench_memory_high_water;
+#endif
 
 int polybench_papi_counters_threadid = POLYBENCH_THREAD_MONITOR;
+int polybench_nb_monitored_threads = 1;
 double polybench_program_total_flops = 0;
+double polybench_program_total_bytes = 0;
+unsigned long long polybench_flop_counter = 0;
 
 #ifdef POLYBENCH_PAPI
 # include <papi.h>
@@ -55,12 +107,45 @@ double polybench_program_total_flops = 0;
   int polybench_papi_eventset;
   int polybench_papi_eventlist[POLYBENCH_MAX_NB_PAPI_COUNTERS];
   long_long polybench_papi_values[POLYBENCH_MAX_NB_PAPI_COUNTERS];
+# ifdef POLYBENCH_MULTI_THREAD_MONITOR
+  int polybench_papi_eventsets[POLYBENCH_MAX_NB_THREADS];
+  long_long polybench_papi_thread_values[POLYBENCH_MAX_NB_THREADS][POLYBENCH_MAX_NB_PAPI_COUNTERS];
+# endif
+
+#endif
+
+#ifdef POLYBENCH_PERF
+# include <errno.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <linux/perf_event.h>
+# define POLYBENCH_MAX_NB_PERF_COUNTERS 96
+/* Maximal number of events scheduled together. Groups are multiplexed
+   by the kernel when there are more events than hardware counters. */
+# ifndef POLYBENCH_PERF_GROUP_SIZE
+#  define POLYBENCH_PERF_GROUP_SIZE 4
+# endif
+  char* _polybench_perf_eventlist[] = {
+#include "perf_counters.list"
+    NULL
+  };
+  /* One row per monitored thread; the totals over all the threads are
+     stored in polybench_perf_values. */
+  int polybench_perf_fds[POLYBENCH_NB_MONITOR_SLOTS][POLYBENCH_MAX_NB_PERF_COUNTERS];
+  int polybench_perf_leaders[POLYBENCH_NB_MONITOR_SLOTS][POLYBENCH_MAX_NB_PERF_COUNTERS];
+  long long polybench_perf_thread_values[POLYBENCH_NB_MONITOR_SLOTS][POLYBENCH_MAX_NB_PERF_COUNTERS];
+  double polybench_perf_running_ratio[POLYBENCH_NB_MONITOR_SLOTS][POLYBENCH_MAX_NB_PERF_COUNTERS];
+  unsigned long long polybench_perf_values[POLYBENCH_MAX_NB_PERF_COUNTERS];
+  int polybench_perf_nb_events = 0;
+  int polybench_perf_initialized = 0;
 
 #endif
 
 /*
- * Allocation table, to enable inter-array padding. All data allocated
- * with polybench_alloc_data should be freed with polybench_free_data.
+ * Allocation table, to enable inter-array padding, to flush the arrays
+ * with POLYBENCH_FLUSH_CLFLUSHOPT, and to report their placement and
+ * footprint. All data allocated with polybench_alloc_data should be
+ * freed with polybench_free_data.
  *
  */
 #define NB_INITIAL_TABLE_ENTRIES 512
@@ -68,502 +153,4468 @@ struct polybench_data_ptrs
 {
   void** user_view;
   void** real_ptr;
+  size_t* size;
+  size_t* alignment;
+  const char** name;
+  int* page_kind;
   int nb_entries;
   int nb_avail_entries;
 };
 static struct polybench_data_ptrs* _polybench_alloc_table = NULL;
 static size_t polybench_inter_array_padding_sz = 0;
 
-/* Timer code (gettimeofday). */
+/* Timer code (clock_gettime, or calibrated TSC). */
 double polybench_t_start, polybench_t_end;
 /* Timer code (RDTSC). */
 unsigned long long int polybench_c_start, polybench_c_end;
+/* Per-run measurements, when the kernel is run several times. */
+static double polybench_run_samples[POLYBENCH_TOTAL_NB_RUNS];
+static int polybench_nb_samples = 0;
 
-static
-double rtclock()
-{
-#if defined(POLYBENCH_TIME) || defined(POLYBENCH_GFLOPS)
-    struct timeval Tp;
-    int stat;
-    stat = gettimeofday (&Tp, NULL);
-    if (stat != 0)
-      printf ("Error return from gettimeofday: %d", stat);
-    return (Tp.tv_sec + Tp.tv_usec * 1.0e-6);
+/* Default clock: monotonic, and not subject to NTP slewing. */
+#ifdef CLOCK_MONOTONIC_RAW
+# define POLYBENCH_CLOCK_ID CLOCK_MONOTONIC_RAW
+# define POLYBENCH_CLOCK_NAME "clock_gettime(CLOCK_MONOTONIC_RAW)"
 #else
-    return 0;
+# define POLYBENCH_CLOCK_ID CLOCK_MONOTONIC
+# define POLYBENCH_CLOCK_NAME "clock_gettime(CLOCK_MONOTONIC)"
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+# define POLYBENCH_HAVE_TSC
 #endif
-}
 
+/* Timer characteristics, computed once by polybench_timer_calibrate. */
+static int polybench_timer_calibrated = 0;
+static const char* polybench_timer_name = POLYBENCH_CLOCK_NAME;
+static const char* polybench_timer_unit = "ns";
+static double polybench_timer_resolution = 0;
+static double polybench_timer_overhead = 0;
+/* TSC to seconds conversion. A null factor means the TSC is not used. */
+static double polybench_tsc_sec_per_tick = 0;
+static unsigned long long int polybench_tsc_origin = 0;
 
-#ifdef POLYBENCH_CYCLE_ACCURATE_TIMER
 static
+double clock_seconds()
+{
+  struct timespec ts;
+  if (clock_gettime (POLYBENCH_CLOCK_ID, &ts) != 0)
+    {
+      fprintf (stderr, "[PolyBench] clock_gettime: cannot read the clock\n");
+      exit (1);
+    }
+  return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+
+#ifdef POLYBENCH_HAVE_TSC
+/* Read the TSC at the start of a measured region. The fences prevent
+   the read from being reordered with the instructions around it. */
+static inline
 unsigned long long int rdtsc()
 {
-  unsigned long long int ret = 0;
   unsigned int cycles_lo;
   unsigned int cycles_hi;
-  __asm__ volatile ("RDTSC" : "=a" (cycles_lo), "=d" (cycles_hi));
-  ret = (unsigned long long int)cycles_hi << 32 | cycles_lo;
-
-  return ret;
+  __asm__ volatile ("lfence\n\t"
+		    "rdtsc\n\t"
+		    "lfence"
+		    : "=a" (cycles_lo), "=d" (cycles_hi) :: "memory");
+  return (unsigned long long int)cycles_hi << 32 | cycles_lo;
 }
-#endif
 
-void polybench_flush_cache()
+/* Read the TSC at the end of a measured region. rdtscp waits for all
+   previous instructions to complete. */
+static inline
+unsigned long long int rdtscp()
 {
-  int cs = POLYBENCH_CACHE_SIZE_KB * 1024 / sizeof(double);
-  double* flush = (double*) calloc (cs, sizeof(double));
-  int i;
-  double tmp = 0.0;
-#ifdef _OPENMP
-#pragma omp parallel for reduction(+:tmp) private(i)
-#endif
-  for (i = 0; i < cs; i++)
-    tmp += flush[i];
-  assert (tmp <= 10.0);
-  free (flush);
+  unsigned int cycles_lo;
+  unsigned int cycles_hi;
+  unsigned int aux;
+  __asm__ volatile ("rdtscp\n\t"
+		    "lfence"
+		    : "=a" (cycles_lo), "=d" (cycles_hi), "=c" (aux) :: "memory");
+  return (unsigned long long int)cycles_hi << 32 | cycles_lo;
 }
 
 
-#ifdef POLYBENCH_LINUX_FIFO_SCHEDULER
-void polybench_linux_fifo_scheduler()
+# ifdef POLYBENCH_TSC_TIMER
+/* The TSC can be used as a wall clock only if it ticks at a constant
+   rate and does not stop in deep C-states. */
+static
+int tsc_is_invariant()
 {
-  /* Use FIFO scheduler to limit OS interference. Program must be run
-     as root, and this works only for Linux kernels. */
-  struct sched_param schedParam;
-  schedParam.sched_priority = sched_get_priority_max (SCHED_FIFO);
-  sched_setscheduler (0, SCHED_FIFO, &schedParam);
+  FILE* f = fopen ("/proc/cpuinfo", "r");
+  char line[4096];
+  int constant = 0, nonstop = 0;
+
+  if (f == NULL)
+    return 0;
+  while (fgets (line, sizeof(line), f) != NULL)
+    if (strncmp (line, "flags", 5) == 0)
+      {
+	constant = strstr (line, " constant_tsc") != NULL;
+	nonstop = strstr (line, " nonstop_tsc") != NULL;
+	break;
+      }
+  fclose (f);
+
+  return constant && nonstop;
 }
+# endif
+#endif
 
 
-void polybench_linux_standard_scheduler()
+static
+double rtclock()
 {
-  /* Restore to standard scheduler policy. */
-  struct sched_param schedParam;
-  schedParam.sched_priority = sched_get_priority_max (SCHED_OTHER);
-  sched_setscheduler (0, SCHED_OTHER, &schedParam);
-}
+#ifdef POLYBENCH_HAVE_TSC
+  if (polybench_tsc_sec_per_tick != 0)
+    return (double)(rdtsc () - polybench_tsc_origin)
+      * polybench_tsc_sec_per_tick;
 #endif
+  return clock_seconds ();
+}
 
-#ifdef POLYBENCH_PAPI
 
+/* Determine the timer backend, its resolution and the overhead of
+   reading it. This is done once, before the first measurement. */
 static
-void test_fail(char *file, int line, char *call, int retval)
+void polybench_timer_calibrate()
 {
-  char buf[128];
+  int i;
 
-  memset(buf, '\0', sizeof(buf));
-  if (retval != 0)
-    fprintf (stdout,"%-40s FAILED\nLine # %d\n", file, line);
+  if (polybench_timer_calibrated)
+    return;
+  polybench_timer_calibrated = 1;
+
+#if defined(POLYBENCH_TSC_TIMER)
+# ifdef POLYBENCH_HAVE_TSC
+  if (tsc_is_invariant ())
+    {
+      /* Measure the TSC frequency against the system clock. */
+      double t0 = clock_seconds ();
+      unsigned long long int c0 = rdtsc ();
+      double t1;
+      while ((t1 = clock_seconds ()) - t0 < 0.02)
+	;
+      unsigned long long int c1 = rdtscp ();
+      polybench_tsc_sec_per_tick = (t1 - t0) / (double)(c1 - c0);
+      polybench_tsc_origin = rdtsc ();
+      polybench_timer_name = "rdtsc (invariant, calibrated)";
+    }
   else
+# endif
+    fprintf (stderr, "[PolyBench][WARNING] No invariant TSC, using %s\n",
+	     POLYBENCH_CLOCK_NAME);
+#endif
+
+#ifdef POLYBENCH_CYCLE_ACCURATE_TIMER
+  unsigned long long int c0, c1, cbest = ~0ULL;
+  for (i = 0; i < 1000; i++)
     {
-      fprintf (stdout,"%-40s SKIPPED\n", file);
-      fprintf (stdout,"Line # %d\n", line);
+      c0 = rdtsc ();
+      c1 = rdtscp ();
+      if (c1 - c0 < cbest)
+	cbest = c1 - c0;
     }
-  if (retval == PAPI_ESYS)
+  polybench_timer_name = "rdtsc";
+  polybench_timer_unit = "cycles";
+  polybench_timer_resolution = 1;
+  polybench_timer_overhead = cbest;
+#else
+  if (polybench_tsc_sec_per_tick == 0)
     {
-      sprintf (buf, "System error in %s", call);
-      perror (buf);
+      struct timespec res;
+      clock_getres (POLYBENCH_CLOCK_ID, &res);
+      polybench_timer_resolution = res.tv_sec * 1.0e9 + res.tv_nsec;
     }
-  else if (retval > 0)
-    fprintf (stdout,"Error: %s\n", call);
-  else if (retval == 0)
-    fprintf (stdout,"Error: %s\n", call);
   else
+    polybench_timer_resolution = polybench_tsc_sec_per_tick * 1.0e9;
+  double best = 1.0e9;
+  for (i = 0; i < 1000; i++)
     {
-      char errstring[PAPI_MAX_STR_LEN];
-      // PAPI 5.4.3 has changed the API for PAPI_perror.
-      #if defined (PAPI_VERSION) && ((PAPI_VERSION_MAJOR(PAPI_VERSION) == 5 && PAPI_VERSION_MINOR(PAPI_VERSION) >= 4) || PAPI_VERSION_MAJOR(PAPI_VERSION) > 5)
-      fprintf (stdout, "Error in %s: %s\n", call, PAPI_strerror(retval));
-      #else
-      PAPI_perror (retval, errstring, PAPI_MAX_STR_LEN);
-      fprintf (stdout,"Error in %s: %s\n", call, errstring);
-      #endif
+      double t0 = rtclock ();
+      double t1 = rtclock ();
+      if (t1 - t0 < best)
+	best = t1 - t0;
     }
-  fprintf (stdout,"\n");
-  if (PAPI_is_initialized ())
-    PAPI_shutdown ();
-  exit (1);
+  polybench_timer_overhead = best * 1.0e9;
+#endif
 }
 
 
-void polybench_papi_init()
+/* Report the timer used for the measurements. */
+static
+void polybench_timer_print_info()
 {
-# ifdef _OPENMP
-#pragma omp parallel
-  {
-#pragma omp master
-    {
-      if (omp_get_max_threads () < polybench_papi_counters_threadid)
-	polybench_papi_counters_threadid = omp_get_max_threads () - 1;
-    }
-#pragma omp barrier
+  printf ("[PolyBench] timer=%s resolution=%0.3f%s overhead=%0.3f%s\n",
+	  polybench_timer_name,
+	  polybench_timer_resolution, polybench_timer_unit,
+	  polybench_timer_overhead, polybench_timer_unit);
+}
 
-    if (omp_get_thread_num () == polybench_papi_counters_threadid)
-      {
-# endif
-	int retval;
-	polybench_papi_eventset = PAPI_NULL;
-	if ((retval = PAPI_library_init (PAPI_VER_CURRENT)) != PAPI_VER_CURRENT)
-	  test_fail (__FILE__, __LINE__, "PAPI_library_init", retval);
-	if ((retval = PAPI_create_eventset (&polybench_papi_eventset))
-	    != PAPI_OK)
-	  test_fail (__FILE__, __LINE__, "PAPI_create_eventset", retval);
-	int k;
-	for (k = 0; _polybench_papi_eventlist[k]; ++k)
-	  {
-	    if ((retval =
-		 PAPI_event_name_to_code (_polybench_papi_eventlist[k],
-					  &(polybench_papi_eventlist[k])))
-		!= PAPI_OK)
-	      test_fail (__FILE__, __LINE__, "PAPI_event_name_to_code", retval);
-	  }
-	polybench_papi_eventlist[k] = 0;
+#if ! defined(POLYBENCH_CACHE_SIZE_KB) || defined(POLYBENCH_ROOFLINE) || defined(POLYBENCH_AUTO_PADDING) || defined(POLYBENCH_AFFINITY) || defined(POLYBENCH_RECORD)
+/* Read an attribute of the cache IDX of CPU from sysfs. */
+static
+int polybench_read_cache_attr(int cpu, int idx, const char* attr,
+			      char* buf, size_t sz)
+{
+  char path[256];
+  FILE* f;
 
+  snprintf (path, sizeof(path),
+	    "/sys/devices/system/cpu/cpu%d/cache/index%d/%s", cpu, idx, attr);
+  buf[0] = '\0';
+  if ((f = fopen (path, "r")) == NULL)
+    return 0;
+  if (fgets (buf, sz, f) == NULL)
+    buf[0] = '\0';
+  fclose (f);
 
-# ifdef _OPENMP
-      }
-  }
-#pragma omp barrier
-# endif
+  return buf[0] != '\0';
 }
+#endif
 
 
-void polybench_papi_close()
+#if ! defined(POLYBENCH_CACHE_SIZE_KB) || defined(POLYBENCH_ROOFLINE)
+/*
+ * Aggregate capacity of the data caches of the machine, in bytes: the
+ * sum of all the L1 data, L2 and L3 instances listed in
+ * /sys/devices/system/cpu/cpuN/cache, each shared cache being counted
+ * once (from the first CPU sharing it). Summing all the levels covers
+ * exclusive (victim) caches.
+ */
+static
+size_t polybench_cache_capacity()
 {
-# ifdef _OPENMP
-#pragma omp parallel
-  {
-    if (omp_get_thread_num () == polybench_papi_counters_threadid)
-      {
-# endif
-	int retval;
-	if ((retval = PAPI_destroy_eventset (&polybench_papi_eventset))
-	    != PAPI_OK)
-	  test_fail (__FILE__, __LINE__, "PAPI_destroy_eventset", retval);
-	if (PAPI_is_initialized ())
-	  PAPI_shutdown ();
-# ifdef _OPENMP
-      }
-  }
-#pragma omp barrier
-# endif
+  static size_t capacity = 0;
+  char path[256], buf[256];
+  int cpu, idx;
+
+  if (capacity > 0)
+    return capacity;
+  for (cpu = 0; ; ++cpu)
+    {
+      snprintf (path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache", cpu);
+      if (access (path, F_OK) != 0)
+	break;
+      for (idx = 0; ; ++idx)
+	{
+	  unsigned long size = 0;
+	  int first = -1;
+	  char unit = 'K';
+	  if (! polybench_read_cache_attr (cpu, idx, "type", buf, sizeof(buf)))
+	    break;
+	  if (! strncmp (buf, "Instruction", 11))
+	    continue;
+	  polybench_read_cache_attr (cpu, idx, "shared_cpu_list", buf, sizeof(buf));
+	  if (sscanf (buf, "%d", &first) == 1 && first != cpu)
+	    continue;
+	  polybench_read_cache_attr (cpu, idx, "size", buf, sizeof(buf));
+	  if (sscanf (buf, "%lu%c", &size, &unit) >= 1)
+	    capacity += size * (unit == 'M' ? 1024 * 1024 :
+				unit == 'G' ? 1024 * 1024 * 1024 :
+				unit == 'K' ? 1024 : 1);
+	}
+    }
+  if (capacity == 0)
+    {
+      long l1 = sysconf (_SC_LEVEL1_DCACHE_SIZE);
+      long l2 = sysconf (_SC_LEVEL2_CACHE_SIZE);
+      long l3 = sysconf (_SC_LEVEL3_CACHE_SIZE);
+      capacity = (l1 > 0 ? l1 : 0) + (l2 > 0 ? l2 : 0) + (l3 > 0 ? l3 : 0);
+    }
+  if (capacity == 0)
+    capacity = (size_t) POLYBENCH_DEFAULT_CACHE_SIZE_KB * 1024;
+
+  return capacity;
 }
+#endif
 
-int polybench_papi_start_counter(int evid)
-{
-# ifndef POLYBENCH_NO_FLUSH_CACHE
-    polybench_flush_cache();
-# endif
 
-# ifdef _OPENMP
-# pragma omp parallel
-  {
-    if (omp_get_thread_num () == polybench_papi_counters_threadid)
-      {
-# endif
+#ifdef POLYBENCH_AUTO_PADDING
+/*
+ * Automatic anti-aliasing padding. When a row of an array spans a
+ * multiple of 8 cache lines, a walk along a column of the array maps
+ * to at most 1/8 of the sets of every cache whose number of sets is a
+ * power of two, and suffers conflict misses. Its pitch is then padded
+ * to an odd number of cache lines (or of POLYBENCH_ROW_ALIGNMENT
+ * units, when larger), which spreads the column over all the sets.
+ * Besides, the k-th array is offset by k times the way size of the L1
+ * cache plus one line, modulo the way size of the L2 cache, so that the
+ * same elements of different arrays do not map to the same sets.
+ * Setting the POLYBENCH_AUTO_PADDING environment variable to "off"
+ * disables both at run time, to measure the unpadded layout with the
+ * same binary.
+ */
+static int polybench_auto_padding_enabled = -1;
+static long polybench_line_size = 64;
+static long polybench_l1_sets = 64;
+static long polybench_l2_sets = 1024;
 
-	int retval = 1;
-	char descr[PAPI_MAX_STR_LEN];
-	PAPI_event_info_t evinfo;
-	PAPI_event_code_to_name (polybench_papi_eventlist[evid], descr);
-	if (PAPI_add_event (polybench_papi_eventset,
-			    polybench_papi_eventlist[evid]) != PAPI_OK)
-	  test_fail (__FILE__, __LINE__, "PAPI_add_event", 1);
-	if (PAPI_get_event_info (polybench_papi_eventlist[evid], &evinfo)
-	    != PAPI_OK)
-	  test_fail (__FILE__, __LINE__, "PAPI_get_event_info", retval);
-	if ((retval = PAPI_start (polybench_papi_eventset)) != PAPI_OK)
-	  test_fail (__FILE__, __LINE__, "PAPI_start", retval);
-# ifdef _OPENMP
-      }
-  }
-#pragma omp barrier
-# endif
-  return 0;
+static
+void polybench_init_auto_padding()
+{
+  const char* env = getenv ("POLYBENCH_AUTO_PADDING");
+  char buf[256];
+  int idx;
+
+  if (polybench_auto_padding_enabled >= 0)
+    return;
+  polybench_auto_padding_enabled =
+    ! (env != NULL && (! strcmp (env, "off") || ! strcmp (env, "0")));
+  for (idx = 0; polybench_read_cache_attr (0, idx, "type", buf, sizeof(buf));
+       ++idx)
+    {
+      int level;
+      long sets;
+      if (! strncmp (buf, "Instruction", 11))
+	continue;
+      polybench_read_cache_attr (0, idx, "level", buf, sizeof(buf));
+      level = atoi (buf);
+      polybench_read_cache_attr (0, idx, "number_of_sets", buf, sizeof(buf));
+      sets = atol (buf);
+      if (level == 1)
+	{
+	  polybench_read_cache_attr (0, idx, "coherency_line_size",
+				     buf, sizeof(buf));
+	  if (atol (buf) > 0)
+	    polybench_line_size = atol (buf);
+	  if (sets > 0)
+	    polybench_l1_sets = sets;
+	}
+      else if (level == 2 && sets > 0)
+	polybench_l2_sets = sets;
+    }
+  fprintf (stderr, "[PolyBench] auto padding: %s, line=%ldB L1 sets=%ld"
+	   " L2 sets=%ld\n", polybench_auto_padding_enabled ? "on" : "off",
+	   polybench_line_size, polybench_l1_sets, polybench_l2_sets);
 }
 
 
-void polybench_papi_stop_counter(int evid)
+/* Row pitch, in elements, of an array whose rows have N elements of
+   ELT_SIZE bytes, and start on ALIGNMENT bytes. */
+long polybench_auto_row_pitch(long n, unsigned long elt_size,
+			      unsigned long alignment)
 {
-# ifdef _OPENMP
-# pragma omp parallel
-  {
-    if (omp_get_thread_num () == polybench_papi_counters_threadid)
-      {
-# endif
-	int retval;
-	long_long values[1];
-	values[0] = 0;
-	if ((retval = PAPI_read (polybench_papi_eventset, &values[0]))
-	    != PAPI_OK)
-	  test_fail (__FILE__, __LINE__, "PAPI_read", retval);
+  static long reported[16];
+  static int nb_reported = 0;
+  long unit = alignment > elt_size ? alignment / elt_size : 1;
+  long pitch;
+  int i;
 
-	if ((retval = PAPI_stop (polybench_papi_eventset, NULL)) != PAPI_OK)
-	  test_fail (__FILE__, __LINE__, "PAPI_stop", retval);
+  polybench_init_auto_padding ();
+  pitch = (n + unit - 1) / unit * unit;
+  if (! polybench_auto_padding_enabled
+      || (n * elt_size) % (8 * polybench_line_size) != 0
+      || polybench_l1_sets < 8)
+    return pitch;
+  if ((long) (unit * elt_size) < polybench_line_size)
+    unit = polybench_line_size / elt_size;
+  pitch = (n + unit - 1) / unit * unit + unit;
+  for (i = 0; i < nb_reported && reported[i] != n; ++i)
+    ;
+  if (i == nb_reported && nb_reported < 16)
+    {
+      reported[nb_reported++] = n;
+      fprintf (stderr, "[PolyBench] auto padding: row pitch %ld -> %ld"
+	       " elements\n", n, pitch);
+    }
 
-	polybench_papi_values[evid] = values[0];
+  return pitch;
+}
 
-	if ((retval = PAPI_remove_event
-	     (polybench_papi_eventset,
-	      polybench_papi_eventlist[evid])) != PAPI_OK)
-	  test_fail (__FILE__, __LINE__, "PAPI_remove_event", retval);
-# ifdef _OPENMP
-      }
-  }
-#pragma omp barrier
-# endif
+
+/* Offset of the next array allocated, in bytes. */
+static
+size_t polybench_auto_array_offset()
+{
+  static long nb_arrays = 0;
+  long l1_way = polybench_l1_sets * polybench_line_size;
+  long l2_way = polybench_l2_sets * polybench_line_size;
+
+  polybench_init_auto_padding ();
+  if (! polybench_auto_padding_enabled)
+    return 0;
+  return (nb_arrays++ * (l1_way + polybench_line_size)) % l2_way;
 }
+#endif
 
 
-void polybench_papi_print()
+/* Number of doubles walked by polybench_flush_cache. */
+static
+size_t polybench_flush_size()
 {
-  int verbose = 0;
-# ifdef _OPENMP
-# pragma omp parallel
-  {
-    if (omp_get_thread_num() == polybench_papi_counters_threadid)
-      {
-#ifdef POLYBENCH_PAPI_VERBOSE
-	verbose = 1;
+#ifdef POLYBENCH_CACHE_SIZE_KB
+  return (size_t) POLYBENCH_CACHE_SIZE_KB * 1024 / sizeof(double);
+#else
+  return POLYBENCH_FLUSH_FACTOR * polybench_cache_capacity () / sizeof(double);
 #endif
-	if (verbose)
-	  printf ("On thread %d:\n", polybench_papi_counters_threadid);
+}
+
+
+/*
+ * Buffer walked by polybench_flush_cache, and reused by the roofline
+ * measurements. It is allocated once, and zero-filled by all the
+ * threads with the static schedule of the walk, so that its pages are
+ * backed before any measurement, and each thread later walks the
+ * pages it touched first (on its own NUMA node). It is grown on demand.
+ */
+static double* polybench_flush_buffer = NULL;
+static size_t polybench_flush_buffer_size = 0;
+
+static
+double* polybench_get_flush_buffer(size_t n)
+{
+  if (n > polybench_flush_buffer_size)
+    {
+      void* buf = NULL;
+      long i;
+      free (polybench_flush_buffer);
+      if (posix_memalign (&buf, 4096, n * sizeof(double)))
+	{
+	  fprintf (stderr, "[PolyBench] posix_memalign: cannot allocate the flush buffer\n");
+	  exit (1);
+	}
+      polybench_flush_buffer = (double*) buf;
+      polybench_flush_buffer_size = n;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
 #endif
-	int evid;
-	for (evid = 0; polybench_papi_eventlist[evid] != 0; ++evid)
+      for (i = 0; i < (long) n; i++)
+	polybench_flush_buffer[i] = 0.0;
+    }
+  return polybench_flush_buffer;
+}
+
+
+#if defined(POLYBENCH_FLUSH_CLFLUSHOPT) || POLYBENCH_NB_RUNS + POLYBENCH_WARMUP_RUNS > 1
+/* Instruction used to flush the arrays, or NULL when the flush buffer
+   is walked. */
+static const char* polybench_flush_method = NULL;
+#endif
+
+#ifdef POLYBENCH_FLUSH_CLFLUSHOPT
+/*
+ * Evict the arrays allocated with polybench_alloc_data from all the
+ * cache levels, one line at a time, with clflushopt when the processor
+ * supports it and clflush otherwise. Returns 0 when there is nothing to
+ * flush (stack arrays) or no such instruction, in which case the flush
+ * buffer is walked instead.
+ */
+# if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  include <cpuid.h>
+
+static
+int polybench_has_clflushopt()
+{
+  unsigned int eax, ebx, ecx, edx;
+  if (! __get_cpuid_count (7, 0, &eax, &ebx, &ecx, &edx))
+    return 0;
+  return (ebx >> 23) & 1;
+}
+
+__attribute__((target("clflushopt")))
+static
+void polybench_clflushopt_range(char* p, long sz)
+{
+  long i;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (i = 0; i < sz; i += 64)
+    _mm_clflushopt (p + i);
+}
+
+static
+void polybench_clflush_range(char* p, long sz)
+{
+  long i;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (i = 0; i < sz; i += 64)
+    _mm_clflush (p + i);
+}
+
+static
+int polybench_flush_arrays()
+{
+  static int has_clflushopt = -1;
+  int i;
+
+  if (_polybench_alloc_table == NULL || _polybench_alloc_table->nb_entries == 0)
+    return 0;
+  if (has_clflushopt < 0)
+    has_clflushopt = polybench_has_clflushopt ();
+  polybench_flush_method = has_clflushopt ? "clflushopt" : "clflush";
+  for (i = 0; i < _polybench_alloc_table->nb_entries; ++i)
+    {
+      char* p = (char*) _polybench_alloc_table->real_ptr[i];
+      long sz = _polybench_alloc_table->size[i];
+      if (has_clflushopt)
+	polybench_clflushopt_range (p, sz);
+      else
+	polybench_clflush_range (p, sz);
+    }
+  _mm_mfence ();
+
+  return 1;
+}
+# else
+static
+int polybench_flush_arrays()
+{
+  return 0;
+}
+# endif
+#endif
+
+
+void polybench_flush_cache()
+{
+  long cs = polybench_flush_size ();
+  double* flush;
+  long i;
+  double tmp = 0.0;
+
+#ifdef POLYBENCH_FLUSH_CLFLUSHOPT
+  if (polybench_flush_arrays ())
+    return;
+#endif
+  flush = polybench_get_flush_buffer (cs);
+  /* One access per cache line. */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+:tmp)
+#endif
+  for (i = 0; i < cs; i += 8)
+    tmp += flush[i];
+  assert (tmp <= 10.0);
+}
+
+
+/*
+ * Conversion of 2D arrays to and from the tile-major layout (see
+ * POLYBENCH_TILED_INDEX in polybench.h): the tiles of
+ * POLYBENCH_TILE_SIZE x POLYBENCH_TILE_SIZE elements are stored one
+ * after the other, row of tiles by row of tiles, and the tiles on the
+ * right and bottom edges are padded with zeros. The conversions are
+ * timed, and their time is reported apart from the kernel time.
+ */
+static double polybench_layout_time = 0;
+static int polybench_layout_nb = 0;
+
+static
+void polybench_convert_2d(char* tiled, char* array, long n, long m,
+			  long pitch, int elt_size, int to_tiled)
+{
+  const long t = POLYBENCH_TILE_SIZE;
+  const long mt = (m + t - 1) / t * t;
+  const long nt = (n + t - 1) / t * t;
+  double start = clock_seconds ();
+  long ti;
+
+  /* With OpenMP, each thread converts, hence first touches, the rows
+     of tiles of the static schedule of the kernels. */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (ti = 0; ti < nt; ti += t)
+    {
+      long tj, u;
+      for (tj = 0; tj < mt; tj += t)
+	for (u = 0; u < t; ++u)
 	  {
-	    if (verbose)
-	      printf ("%s=", _polybench_papi_eventlist[evid]);
-	    printf ("%llu ", polybench_papi_values[evid]);
-	    if (verbose)
-	      printf ("\n");
+	    char* trow = tiled + (ti * mt + tj * t + u * t) * elt_size;
+	    long w = ti + u < n && tj < m ? (m - tj < t ? m - tj : t) : 0;
+	    char* arow = array + ((ti + u) * pitch + tj) * elt_size;
+	    if (! to_tiled)
+	      memcpy (arow, trow, w * elt_size);
+	    else
+	      {
+		memcpy (trow, arow, w * elt_size);
+		memset (trow + w * elt_size, 0, (t - w) * elt_size);
+	      }
 	  }
-	printf ("\n");
-# ifdef _OPENMP
-      }
+    }
+  polybench_layout_time += clock_seconds () - start;
+  polybench_layout_nb++;
+}
+
+
+void polybench_tile_2d(void* tiled, void* array, long n, long m,
+		       long pitch, int elt_size)
+{
+  polybench_convert_2d (tiled, array, n, m, pitch, elt_size, 1);
+}
+
+
+void polybench_untile_2d(void* array, void* tiled, long n, long m,
+			 long pitch, int elt_size)
+{
+  polybench_convert_2d (tiled, array, n, m, pitch, elt_size, 0);
+}
+
+
+/* Time of the layout conversions, per run, on stderr. */
+static
+void polybench_print_layout_time()
+{
+  if (polybench_layout_nb > 0)
+    fprintf (stderr, "[PolyBench] layout conversion: %0.6f s per run"
+	     " (%d conversions, not included in the kernel time)\n",
+	     polybench_layout_time / POLYBENCH_TOTAL_NB_RUNS,
+	     polybench_layout_nb);
+}
+
+
+/* Reports, on stderr, which complete the output of all the
+   instruments. */
+static
+void polybench_print_reports()
+{
+#if defined(POLYBENCH_AFFINITY) || defined(POLYBENCH_RECORD)
+  polybench_sample_thread_cpus ();
+#endif
+  polybench_print_layout_time ();
+#ifdef POLYBENCH_AFFINITY
+  polybench_print_thread_cpus ();
+#endif
+#ifdef POLYBENCH_MEMORY_REPORT
+  polybench_print_memory ();
+#endif
+}
+
+
+#ifdef POLYBENCH_LINUX_FIFO_SCHEDULER
+void polybench_linux_fifo_scheduler()
+{
+  /* Use FIFO scheduler to limit OS interference. Program must be run
+     as root, and this works only for Linux kernels. */
+  struct sched_param schedParam;
+  schedParam.sched_priority = sched_get_priority_max (SCHED_FIFO);
+  sched_setscheduler (0, SCHED_FIFO, &schedParam);
+}
+
+
+void polybench_linux_standard_scheduler()
+{
+  /* Restore to standard scheduler policy. */
+  struct sched_param schedParam;
+  schedParam.sched_priority = sched_get_priority_max (SCHED_OTHER);
+  sched_setscheduler (0, SCHED_OTHER, &schedParam);
+}
+#endif
+
+#if defined(POLYBENCH_MULTI_THREAD_MONITOR) && \
+  (defined(POLYBENCH_PAPI) || defined(POLYBENCH_PERF))
+/*
+ * Print the counters of each monitored thread, then the spread of each
+ * event over the threads. The imbalance is the ratio of the maximal
+ * count to the average count, 1.00 being a perfect balance.
+ */
+static
+void polybench_print_thread_counters(char** names, int nb_events,
+				     const long long* values, int stride)
+{
+  int t, evid;
+
+  for (t = 0; t < polybench_nb_monitored_threads; ++t)
+    {
+      printf ("[PolyBench] thread %d:", t);
+      for (evid = 0; evid < nb_events; ++evid)
+	printf (" %lld", values[t * stride + evid]);
+      printf ("\n");
+    }
+  for (evid = 0; evid < nb_events; ++evid)
+    {
+      long long min = values[evid];
+      long long max = values[evid];
+      int tmin = 0, tmax = 0;
+      double total = 0;
+      for (t = 0; t < polybench_nb_monitored_threads; ++t)
+	{
+	  long long val = values[t * stride + evid];
+	  total += val;
+	  if (val < min)
+	    {
+	      min = val;
+	      tmin = t;
+	    }
+	  if (val > max)
+	    {
+	      max = val;
+	      tmax = t;
+	    }
+	}
+      double mean = total / polybench_nb_monitored_threads;
+      printf ("[PolyBench] %s: total=%0.0f min=%lld (thread %d)"
+	      " max=%lld (thread %d) imbalance=%0.2f\n",
+	      names[evid], total, min, tmin, max, tmax,
+	      mean > 0 ? max / mean : 1.0);
+    }
+}
+
+
+static
+void polybench_check_nb_threads()
+{
+  if (omp_get_max_threads () > POLYBENCH_MAX_NB_THREADS)
+    {
+      fprintf (stderr, "[PolyBench] More than %d threads to monitor, "
+	       "increase POLYBENCH_MAX_NB_THREADS\n", POLYBENCH_MAX_NB_THREADS);
+      exit (1);
+    }
+}
+#endif
+
+#ifdef POLYBENCH_PAPI
+
+static
+void test_fail(char *file, int line, char *call, int retval)
+{
+  char buf[128];
+
+  memset(buf, '\0', sizeof(buf));
+  if (retval != 0)
+    fprintf (stdout,"%-40s FAILED\nLine # %d\n", file, line);
+  else
+    {
+      fprintf (stdout,"%-40s SKIPPED\n", file);
+      fprintf (stdout,"Line # %d\n", line);
+    }
+  if (retval == PAPI_ESYS)
+    {
+      sprintf (buf, "System error in %s", call);
+      perror (buf);
+    }
+  else if (retval > 0)
+    fprintf (stdout,"Error: %s\n", call);
+  else if (retval == 0)
+    fprintf (stdout,"Error: %s\n", call);
+  else
+    {
+      char errstring[PAPI_MAX_STR_LEN];
+      // PAPI 5.4.3 has changed the API for PAPI_perror.
+      #if defined (PAPI_VERSION) && ((PAPI_VERSION_MAJOR(PAPI_VERSION) == 5 && PAPI_VERSION_MINOR(PAPI_VERSION) >= 4) || PAPI_VERSION_MAJOR(PAPI_VERSION) > 5)
+      fprintf (stdout, "Error in %s: %s\n", call, PAPI_strerror(retval));
+      #else
+      PAPI_perror (retval, errstring, PAPI_MAX_STR_LEN);
+      fprintf (stdout,"Error in %s: %s\n", call, errstring);
+      #endif
+    }
+  fprintf (stdout,"\n");
+  if (PAPI_is_initialized ())
+    PAPI_shutdown ();
+  exit (1);
+}
+
+
+# ifdef POLYBENCH_MULTI_THREAD_MONITOR
+
+static
+unsigned long polybench_papi_thread_id()
+{
+  return (unsigned long) omp_get_thread_num ();
+}
+
+
+/*
+ * Every OpenMP thread registers itself to PAPI and owns an event set.
+ * The thread team of the kernel is assumed to be the team used here.
+ */
+void polybench_papi_init()
+{
+  int retval, k;
+
+  polybench_check_nb_threads ();
+  if ((retval = PAPI_library_init (PAPI_VER_CURRENT)) != PAPI_VER_CURRENT)
+    test_fail (__FILE__, __LINE__, "PAPI_library_init", retval);
+  if ((retval = PAPI_thread_init (polybench_papi_thread_id)) != PAPI_OK)
+    test_fail (__FILE__, __LINE__, "PAPI_thread_init", retval);
+  for (k = 0; _polybench_papi_eventlist[k]; ++k)
+    {
+      if ((retval =
+	   PAPI_event_name_to_code (_polybench_papi_eventlist[k],
+				    &(polybench_papi_eventlist[k])))
+	  != PAPI_OK)
+	test_fail (__FILE__, __LINE__, "PAPI_event_name_to_code", retval);
+    }
+  polybench_papi_eventlist[k] = 0;
+
+#pragma omp parallel
+  {
+    int tid = omp_get_thread_num ();
+    int ret;
+#pragma omp single
+    polybench_nb_monitored_threads = omp_get_num_threads ();
+    if ((ret = PAPI_register_thread ()) != PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_register_thread", ret);
+    polybench_papi_eventsets[tid] = PAPI_NULL;
+    if ((ret = PAPI_create_eventset (&polybench_papi_eventsets[tid]))
+	!= PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_create_eventset", ret);
   }
-#pragma omp barrier
+}
+
+
+void polybench_papi_close()
+{
+#pragma omp parallel
+  {
+    int tid = omp_get_thread_num ();
+    int retval;
+    if ((retval = PAPI_destroy_eventset (&polybench_papi_eventsets[tid]))
+	!= PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_destroy_eventset", retval);
+    if ((retval = PAPI_unregister_thread ()) != PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_unregister_thread", retval);
+  }
+  if (PAPI_is_initialized ())
+    PAPI_shutdown ();
+}
+
+
+int polybench_papi_start_counter(int evid)
+{
+# ifndef POLYBENCH_NO_FLUSH_CACHE
+    polybench_flush_cache();
 # endif
+
+#pragma omp parallel
+  {
+    int tid = omp_get_thread_num ();
+    int retval;
+    if (PAPI_add_event (polybench_papi_eventsets[tid],
+			polybench_papi_eventlist[evid]) != PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_add_event", 1);
+    if ((retval = PAPI_start (polybench_papi_eventsets[tid])) != PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_start", retval);
+  }
+  return 0;
+}
+
+
+void polybench_papi_stop_counter(int evid)
+{
+  int t;
+
+#pragma omp parallel
+  {
+    int tid = omp_get_thread_num ();
+    int retval;
+    long_long value = 0;
+    if ((retval = PAPI_read (polybench_papi_eventsets[tid], &value))
+	!= PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_read", retval);
+    if ((retval = PAPI_stop (polybench_papi_eventsets[tid], NULL)) != PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_stop", retval);
+    polybench_papi_thread_values[tid][evid] = value;
+    if ((retval = PAPI_remove_event
+	 (polybench_papi_eventsets[tid],
+	  polybench_papi_eventlist[evid])) != PAPI_OK)
+      test_fail (__FILE__, __LINE__, "PAPI_remove_event", retval);
+  }
+  polybench_papi_values[evid] = 0;
+  for (t = 0; t < polybench_nb_monitored_threads; ++t)
+    polybench_papi_values[evid] += polybench_papi_thread_values[t][evid];
+}
+
+
+void polybench_papi_print()
+{
+  int verbose = 0;
+  int evid, nb_events;
+#ifdef POLYBENCH_PAPI_VERBOSE
+  verbose = 1;
+#endif
+  for (nb_events = 0; polybench_papi_eventlist[nb_events] != 0; ++nb_events)
+    ;
+  polybench_print_thread_counters (_polybench_papi_eventlist, nb_events,
+				   &polybench_papi_thread_values[0][0],
+				   POLYBENCH_MAX_NB_PAPI_COUNTERS);
+  if (verbose)
+    printf ("Total on %d threads:\n", polybench_nb_monitored_threads);
+  for (evid = 0; evid < nb_events; ++evid)
+    {
+      if (verbose)
+	printf ("%s=", _polybench_papi_eventlist[evid]);
+      printf ("%llu ", polybench_papi_values[evid]);
+      if (verbose)
+	printf ("\n");
+    }
+  printf ("\n");
+  polybench_print_reports ();
+#ifdef POLYBENCH_RECORD
+  polybench_write_record (_polybench_papi_eventlist,
+			  (const long long*) polybench_papi_values, nb_events);
+#endif
+}
+
+# else
+
+void polybench_papi_init()
+{
+# ifdef _OPENMP
+#pragma omp parallel
+  {
+#pragma omp master
+    {
+      if (omp_get_max_threads () < polybench_papi_counters_threadid)
+	polybench_papi_counters_threadid = omp_get_max_threads () - 1;
+    }
+#pragma omp barrier
+
+    if (omp_get_thread_num () == polybench_papi_counters_threadid)
+      {
+# endif
+	int retval;
+	polybench_papi_eventset = PAPI_NULL;
+	if ((retval = PAPI_library_init (PAPI_VER_CURRENT)) != PAPI_VER_CURRENT)
+	  test_fail (__FILE__, __LINE__, "PAPI_library_init", retval);
+	if ((retval = PAPI_create_eventset (&polybench_papi_eventset))
+	    != PAPI_OK)
+	  test_fail (__FILE__, __LINE__, "PAPI_create_eventset", retval);
+	int k;
+	for (k = 0; _polybench_papi_eventlist[k]; ++k)
+	  {
+	    if ((retval =
+		 PAPI_event_name_to_code (_polybench_papi_eventlist[k],
+					  &(polybench_papi_eventlist[k])))
+		!= PAPI_OK)
+	      test_fail (__FILE__, __LINE__, "PAPI_event_name_to_code", retval);
+	  }
+	polybench_papi_eventlist[k] = 0;
+
+
+# ifdef _OPENMP
+      }
+  }
+#pragma omp barrier
+# endif
+}
+
+
+void polybench_papi_close()
+{
+# ifdef _OPENMP
+#pragma omp parallel
+  {
+    if (omp_get_thread_num () == polybench_papi_counters_threadid)
+      {
+# endif
+	int retval;
+	if ((retval = PAPI_destroy_eventset (&polybench_papi_eventset))
+	    != PAPI_OK)
+	  test_fail (__FILE__, __LINE__, "PAPI_destroy_eventset", retval);
+	if (PAPI_is_initialized ())
+	  PAPI_shutdown ();
+# ifdef _OPENMP
+      }
+  }
+#pragma omp barrier
+# endif
+}
+
+int polybench_papi_start_counter(int evid)
+{
+# ifndef POLYBENCH_NO_FLUSH_CACHE
+    polybench_flush_cache();
+# endif
+
+# ifdef _OPENMP
+# pragma omp parallel
+  {
+    if (omp_get_thread_num () == polybench_papi_counters_threadid)
+      {
+# endif
+
+	int retval = 1;
+	char descr[PAPI_MAX_STR_LEN];
+	PAPI_event_info_t evinfo;
+	PAPI_event_code_to_name (polybench_papi_eventlist[evid], descr);
+	if (PAPI_add_event (polybench_papi_eventset,
+			    polybench_papi_eventlist[evid]) != PAPI_OK)
+	  test_fail (__FILE__, __LINE__, "PAPI_add_event", 1);
+	if (PAPI_get_event_info (polybench_papi_eventlist[evid], &evinfo)
+	    != PAPI_OK)
+	  test_fail (__FILE__, __LINE__, "PAPI_get_event_info", retval);
+	if ((retval = PAPI_start (polybench_papi_eventset)) != PAPI_OK)
+	  test_fail (__FILE__, __LINE__, "PAPI_start", retval);
+# ifdef _OPENMP
+      }
+  }
+#pragma omp barrier
+# endif
+  return 0;
+}
+
+
+void polybench_papi_stop_counter(int evid)
+{
+# ifdef _OPENMP
+# pragma omp parallel
+  {
+    if (omp_get_thread_num () == polybench_papi_counters_threadid)
+      {
+# endif
+	int retval;
+	long_long values[1];
+	values[0] = 0;
+	if ((retval = PAPI_read (polybench_papi_eventset, &values[0]))
+	    != PAPI_OK)
+	  test_fail (__FILE__, __LINE__, "PAPI_read", retval);
+
+	if ((retval = PAPI_stop (polybench_papi_eventset, NULL)) != PAPI_OK)
+	  test_fail (__FILE__, __LINE__, "PAPI_stop", retval);
+
+	polybench_papi_values[evid] = values[0];
+
+	if ((retval = PAPI_remove_event
+	     (polybench_papi_eventset,
+	      polybench_papi_eventlist[evid])) != PAPI_OK)
+	  test_fail (__FILE__, __LINE__, "PAPI_remove_event", retval);
+# ifdef _OPENMP
+      }
+  }
+#pragma omp barrier
+# endif
+}
+
+
+void polybench_papi_print()
+{
+  int verbose = 0;
+# ifdef _OPENMP
+# pragma omp parallel
+  {
+    if (omp_get_thread_num() == polybench_papi_counters_threadid)
+      {
+#ifdef POLYBENCH_PAPI_VERBOSE
+	verbose = 1;
+#endif
+	if (verbose)
+	  printf ("On thread %d:\n", polybench_papi_counters_threadid);
+#endif
+	int evid;
+	for (evid = 0; polybench_papi_eventlist[evid] != 0; ++evid)
+	  {
+	    if (verbose)
+	      printf ("%s=", _polybench_papi_eventlist[evid]);
+	    printf ("%llu ", polybench_papi_values[evid]);
+	    if (verbose)
+	      printf ("\n");
+	  }
+	printf ("\n");
+	polybench_print_reports ();
+#ifdef POLYBENCH_RECORD
+	polybench_write_record (_polybench_papi_eventlist,
+				(const long long*) polybench_papi_values, evid);
+#endif
+# ifdef _OPENMP
+      }
+  }
+#pragma omp barrier
+# endif
+}
+
+# endif
+/* ! POLYBENCH_MULTI_THREAD_MONITOR */
+
+#endif
+/* ! POLYBENCH_PAPI */
+
+#ifdef POLYBENCH_PERF
+
+/* Generic events, and the PAPI presets which have a generic equivalent. */
+# define PERF_CACHE_EVENT(id, op, res)					\
+  (PERF_COUNT_HW_CACHE_##id | (PERF_COUNT_HW_CACHE_OP_##op << 8)	\
+   | (PERF_COUNT_HW_CACHE_RESULT_##res << 16))
+static const struct
+{
+  const char* name;
+  unsigned int type;
+  unsigned long long config;
+} polybench_perf_event_table[] = {
+  { "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { "cpu-cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { "PAPI_TOT_CYC", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+  { "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { "PAPI_TOT_INS", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+  { "cache-references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES },
+  { "cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+  { "branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+  { "branch-instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+  { "PAPI_BR_INS", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+  { "branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { "PAPI_BR_MSP", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+  { "bus-cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BUS_CYCLES },
+  { "stalled-cycles-frontend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND },
+  { "stalled-cycles-backend", PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND },
+  { "ref-cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES },
+  { "PAPI_REF_CYC", PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES },
+  { "L1-dcache-loads", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(L1D, READ, ACCESS) },
+  { "L1-dcache-load-misses", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(L1D, READ, MISS) },
+  { "PAPI_L1_DCM", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(L1D, READ, MISS) },
+  { "L1-dcache-stores", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(L1D, WRITE, ACCESS) },
+  { "L1-icache-load-misses", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(L1I, READ, MISS) },
+  { "PAPI_L1_ICM", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(L1I, READ, MISS) },
+  { "LLC-loads", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(LL, READ, ACCESS) },
+  { "LLC-load-misses", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(LL, READ, MISS) },
+  { "LLC-stores", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(LL, WRITE, ACCESS) },
+  { "LLC-store-misses", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(LL, WRITE, MISS) },
+  { "dTLB-loads", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(DTLB, READ, ACCESS) },
+  { "dTLB-load-misses", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(DTLB, READ, MISS) },
+  { "PAPI_TLB_DM", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(DTLB, READ, MISS) },
+  { "iTLB-load-misses", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(ITLB, READ, MISS) },
+  { "PAPI_TLB_IM", PERF_TYPE_HW_CACHE, PERF_CACHE_EVENT(ITLB, READ, MISS) },
+  { "cpu-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK },
+  { "task-clock", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+  { "page-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+  { "minor-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN },
+  { "major-faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ },
+  { "context-switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+  { "cpu-migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS },
+  { NULL, 0, 0 }
+};
+
+
+static
+int perf_event_attr_from_name(const char* name, struct perf_event_attr* attr)
+{
+  int i;
+
+  memset (attr, 0, sizeof(struct perf_event_attr));
+  attr->size = sizeof(struct perf_event_attr);
+  /* Raw event, e.g. r01c2. */
+  if (name[0] == 'r' && name[1] != '\0'
+      && strspn (name + 1, "0123456789abcdefABCDEF") == strlen (name + 1))
+    {
+      attr->type = PERF_TYPE_RAW;
+      attr->config = strtoull (name + 1, NULL, 16);
+      return 0;
+    }
+  for (i = 0; polybench_perf_event_table[i].name; ++i)
+    if (! strcmp (polybench_perf_event_table[i].name, name))
+      {
+	attr->type = polybench_perf_event_table[i].type;
+	attr->config = polybench_perf_event_table[i].config;
+	return 0;
+      }
+
+  return 1;
+}
+
+
+/*
+ * Open all the events of the counter list on the calling thread, in
+ * groups of at most POLYBENCH_PERF_GROUP_SIZE events, in row TID of the
+ * descriptor table. Events which cannot be opened read as 0.
+ */
+static
+void polybench_perf_open_thread(int tid)
+{
+  int k, leader = -1, group_size = 0;
+
+  for (k = 0; k < polybench_perf_nb_events; ++k)
+    {
+      struct perf_event_attr attr;
+
+      polybench_perf_fds[tid][k] = -1;
+      polybench_perf_leaders[tid][k] = -1;
+      if (perf_event_attr_from_name (_polybench_perf_eventlist[k], &attr))
+	continue;
+      if (group_size == POLYBENCH_PERF_GROUP_SIZE)
+	{
+	  leader = -1;
+	  group_size = 0;
+	}
+      attr.disabled = (leader == -1);
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP |
+	PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      polybench_perf_fds[tid][k] =
+	syscall (SYS_perf_event_open, &attr, 0, -1,
+		 leader == -1 ? -1 : polybench_perf_fds[tid][leader], 0);
+      if (polybench_perf_fds[tid][k] == -1)
+	{
+	  if (tid == 0)
+	    fprintf (stderr, "[PolyBench][WARNING] perf_event_open(%s): %s\n",
+		     _polybench_perf_eventlist[k], strerror (errno));
+	  continue;
+	}
+      if (leader == -1)
+	leader = k;
+      polybench_perf_leaders[tid][k] = leader;
+      group_size++;
+    }
+}
+
+
+/*
+ * Open the counters on the calling thread or, with
+ * POLYBENCH_MONITOR_ALL_THREADS, on every thread of the OpenMP team.
+ */
+void polybench_perf_init()
+{
+  int k;
+
+  for (k = 0; _polybench_perf_eventlist[k]; ++k)
+    {
+      struct perf_event_attr attr;
+
+      if (k == POLYBENCH_MAX_NB_PERF_COUNTERS)
+	{
+	  fprintf (stderr, "[PolyBench] Too many perf counters\n");
+	  exit (1);
+	}
+      if (perf_event_attr_from_name (_polybench_perf_eventlist[k], &attr))
+	fprintf (stderr, "[PolyBench][WARNING] Unknown perf event: %s\n",
+		 _polybench_perf_eventlist[k]);
+    }
+  polybench_perf_nb_events = k;
+#ifdef POLYBENCH_MULTI_THREAD_MONITOR
+  polybench_check_nb_threads ();
+#pragma omp parallel
+  {
+#pragma omp single
+    polybench_nb_monitored_threads = omp_get_num_threads ();
+    polybench_perf_open_thread (omp_get_thread_num ());
+  }
+#else
+  polybench_perf_open_thread (0);
+#endif
+  polybench_perf_initialized = 1;
+}
+
+
+void polybench_perf_close()
+{
+  int t, k;
+
+  for (t = 0; t < polybench_nb_monitored_threads; ++t)
+    for (k = 0; k < polybench_perf_nb_events; ++k)
+      if (polybench_perf_fds[t][k] != -1)
+	close (polybench_perf_fds[t][k]);
+  polybench_perf_initialized = 0;
+}
+
+
+void polybench_perf_start()
+{
+  int t, k;
+
+  if (! polybench_perf_initialized)
+    polybench_perf_init ();
+  for (t = 0; t < polybench_nb_monitored_threads; ++t)
+    for (k = 0; k < polybench_perf_nb_events; ++k)
+      if (polybench_perf_leaders[t][k] == k)
+	{
+	  ioctl (polybench_perf_fds[t][k], PERF_EVENT_IOC_RESET,
+		 PERF_IOC_FLAG_GROUP);
+	  ioctl (polybench_perf_fds[t][k], PERF_EVENT_IOC_ENABLE,
+		 PERF_IOC_FLAG_GROUP);
+	}
+}
+
+
+/*
+ * Stop the counters, and read all the groups. Counts are scaled by
+ * time_enabled / time_running to account for multiplexing, then summed
+ * over the monitored threads.
+ */
+void polybench_perf_stop()
+{
+  int t, k, i;
+  unsigned long long buf[3 + POLYBENCH_PERF_GROUP_SIZE];
+
+  for (t = 0; t < polybench_nb_monitored_threads; ++t)
+    for (k = 0; k < polybench_perf_nb_events; ++k)
+      if (polybench_perf_leaders[t][k] == k)
+	ioctl (polybench_perf_fds[t][k], PERF_EVENT_IOC_DISABLE,
+	       PERF_IOC_FLAG_GROUP);
+#ifdef POLYBENCH_LINUX_FIFO_SCHEDULER
+  polybench_linux_standard_scheduler ();
+#endif
+
+  for (k = 0; k < polybench_perf_nb_events; ++k)
+    polybench_perf_values[k] = 0;
+  for (t = 0; t < polybench_nb_monitored_threads; ++t)
+    {
+      for (k = 0; k < polybench_perf_nb_events; ++k)
+	{
+	  polybench_perf_thread_values[t][k] = 0;
+	  polybench_perf_running_ratio[t][k] = 0;
+	}
+      for (k = 0; k < polybench_perf_nb_events; ++k)
+	{
+	  if (polybench_perf_leaders[t][k] != k)
+	    continue;
+	  /* Layout: nr, time_enabled, time_running, values[nr]. */
+	  if (read (polybench_perf_fds[t][k], buf, sizeof(buf)) < 0)
+	    {
+	      fprintf (stderr, "[PolyBench][WARNING] Cannot read perf counters"
+		       " of %s on thread %d\n", _polybench_perf_eventlist[k], t);
+	      continue;
+	    }
+	  double ratio = buf[1] ? (double) buf[2] / buf[1] : 0;
+	  unsigned long long slot = 0;
+	  for (i = k; i < polybench_perf_nb_events && slot < buf[0]; ++i)
+	    if (polybench_perf_leaders[t][i] == k)
+	      {
+		unsigned long long val = buf[3 + slot++];
+		polybench_perf_running_ratio[t][i] = ratio;
+		polybench_perf_thread_values[t][i] = ratio > 0 ? val / ratio : 0;
+	      }
+	}
+      for (k = 0; k < polybench_perf_nb_events; ++k)
+	polybench_perf_values[k] += polybench_perf_thread_values[t][k];
+    }
+}
+
+
+#ifdef POLYBENCH_REGIONS
+/*
+ * Read the current, unscaled, counts of the first NB events of the
+ * counters opened in row TID, without stopping them.
+ */
+static
+void polybench_perf_read_thread(int tid, long long* values, int nb)
+{
+  int k, i;
+  unsigned long long buf[3 + POLYBENCH_PERF_GROUP_SIZE];
+
+  for (k = 0; k < nb; ++k)
+    values[k] = 0;
+  for (k = 0; k < nb; ++k)
+    {
+      if (polybench_perf_leaders[tid][k] != k
+	  || read (polybench_perf_fds[tid][k], buf, sizeof(buf)) < 0)
+	continue;
+      unsigned long long slot = 0;
+      for (i = k; i < nb && slot < buf[0]; ++i)
+	if (polybench_perf_leaders[tid][i] == k)
+	  values[i] = buf[3 + slot++];
+    }
+}
+#endif
+
+
+void polybench_perf_print()
+{
+  int verbose = 0;
+  int t, evid;
+#if defined(POLYBENCH_PERF_VERBOSE) || defined(POLYBENCH_PAPI_VERBOSE)
+  verbose = 1;
+#endif
+#ifdef POLYBENCH_MULTI_THREAD_MONITOR
+  polybench_print_thread_counters (_polybench_perf_eventlist,
+				   polybench_perf_nb_events,
+				   &polybench_perf_thread_values[0][0],
+				   POLYBENCH_MAX_NB_PERF_COUNTERS);
+  if (verbose)
+    printf ("Total on %d threads:\n", polybench_nb_monitored_threads);
+#else
+  if (verbose)
+    printf ("On thread %d:\n", polybench_papi_counters_threadid);
+#endif
+  for (evid = 0; evid < polybench_perf_nb_events; ++evid)
+    {
+      if (verbose)
+	printf ("%s=", _polybench_perf_eventlist[evid]);
+      printf ("%llu ", polybench_perf_values[evid]);
+      if (verbose)
+	{
+	  double ratio = 1;
+	  for (t = 0; t < polybench_nb_monitored_threads; ++t)
+	    if (polybench_perf_running_ratio[t][evid] < ratio)
+	      ratio = polybench_perf_running_ratio[t][evid];
+	  if (ratio < 1)
+	    printf ("(scaled, running %0.1f%%)", ratio * 100);
+	  printf ("\n");
+	}
+    }
+  printf ("\n");
+  polybench_print_reports ();
+#ifdef POLYBENCH_RECORD
+  polybench_write_record (_polybench_perf_eventlist,
+			  (const long long*) polybench_perf_values,
+			  polybench_perf_nb_events);
+#endif
+}
+
+#endif
+/* ! POLYBENCH_PERF */
+
+#ifdef POLYBENCH_REGIONS
+/*
+ * Region profiling. Each (parent, name) pair is a node of the region
+ * tree; a region entered again while it is already active on the
+ * thread (recursion) is folded into the active node. The threads of a
+ * parallel block which have no active region of their own enter their
+ * regions under the region active where the block started. Time is
+ * accumulated per thread. The perf counters, when available, are read
+ * on all the monitored threads for a region entered outside of a
+ * parallel block, and on the entering thread otherwise.
+ */
+# ifndef POLYBENCH_MAX_NB_REGIONS
+#  define POLYBENCH_MAX_NB_REGIONS 64
+# endif
+# ifndef POLYBENCH_MAX_REGION_DEPTH
+#  define POLYBENCH_MAX_REGION_DEPTH 256
+# endif
+# define POLYBENCH_MAX_NB_REGION_COUNTERS 8
+
+struct polybench_region
+{
+  const char* name;
+  int parent;
+  double time[POLYBENCH_MAX_NB_THREADS];
+  long long calls[POLYBENCH_MAX_NB_THREADS];
+  long long counters[POLYBENCH_MAX_NB_REGION_COUNTERS];
+};
+
+struct polybench_region_frame
+{
+  int region;
+  int folded;
+  int all_threads;
+  double start;
+  long long counters[POLYBENCH_MAX_NB_REGION_COUNTERS];
+};
+
+static struct polybench_region polybench_regions[POLYBENCH_MAX_NB_REGIONS];
+static int polybench_nb_regions = 0;
+static int polybench_region_nb_counters = 0;
+static int polybench_region_print_registered = 0;
+static __thread struct polybench_region_frame
+  polybench_region_stack[POLYBENCH_MAX_REGION_DEPTH];
+static __thread int polybench_region_depth = 0;
+/* Region active outside of parallel blocks, shared with their threads. */
+static int polybench_region_current = -1;
+
+
+static
+int polybench_region_thread_id()
+{
+# ifdef _OPENMP
+  int tid = omp_get_thread_num ();
+  if (tid >= POLYBENCH_MAX_NB_THREADS)
+    {
+      fprintf (stderr, "[PolyBench] More than %d threads in regions, "
+	       "increase POLYBENCH_MAX_NB_THREADS\n", POLYBENCH_MAX_NB_THREADS);
+      exit (1);
+    }
+  return tid;
+# else
+  return 0;
+# endif
+}
+
+
+/* True outside of an active parallel block. */
+static
+int polybench_region_serial()
+{
+# ifdef _OPENMP
+  return ! omp_in_parallel ();
+# else
+  return 1;
+# endif
+}
+
+
+# ifdef POLYBENCH_PERF
+/*
+ * Read the unscaled counts of the region counters, summed over all the
+ * monitored threads if ALL_THREADS, or of thread TID. Return 0 when the
+ * counters cannot be read.
+ */
+static
+int polybench_region_read_counters(int tid, int all_threads,
+				   long long* values)
+{
+  long long thread_values[POLYBENCH_MAX_NB_REGION_COUNTERS];
+  int t, k;
+
+  if (! polybench_perf_initialized)
+    return 0;
+  if (! all_threads)
+    {
+      if (tid >= polybench_nb_monitored_threads)
+	return 0;
+      polybench_perf_read_thread (tid, values, polybench_region_nb_counters);
+      return 1;
+    }
+  for (k = 0; k < polybench_region_nb_counters; ++k)
+    values[k] = 0;
+  for (t = 0; t < polybench_nb_monitored_threads; ++t)
+    {
+      polybench_perf_read_thread (t, thread_values,
+				  polybench_region_nb_counters);
+      for (k = 0; k < polybench_region_nb_counters; ++k)
+	values[k] += thread_values[k];
+    }
+  return 1;
+}
+# endif
+
+
+static
+int polybench_region_lookup(int parent, const char* name)
+{
+  int r;
+
+  for (r = 0; r < polybench_nb_regions; ++r)
+    if (polybench_regions[r].parent == parent
+	&& (polybench_regions[r].name == name
+	    || ! strcmp (polybench_regions[r].name, name)))
+      return r;
+  return -1;
+}
+
+
+static
+void polybench_region_print_tree(int parent, int depth, double parent_time)
+{
+  int r, t;
+
+  for (r = 0; r < polybench_nb_regions; ++r)
+    {
+      struct polybench_region* reg = &polybench_regions[r];
+      double max = 0, total = 0;
+      long long calls = 0;
+      int nb_threads = 0;
+      if (reg->parent != parent)
+	continue;
+      for (t = 0; t < POLYBENCH_MAX_NB_THREADS; ++t)
+	if (reg->calls[t])
+	  {
+	    nb_threads++;
+	    calls += reg->calls[t];
+	    total += reg->time[t];
+	    if (reg->time[t] > max)
+	      max = reg->time[t];
+	  }
+      fprintf (stderr, "[PolyBench] %*s%-*s %10lld %12.6f %12.6f %4d %6.2f %6.1f%%",
+	       2 * depth, "", 32 - 2 * depth, reg->name, calls, max, total,
+	       nb_threads, total > 0 ? max * nb_threads / total : 1.0,
+	       parent_time > 0 ? max / parent_time * 100 : 100.0);
+      for (t = 0; t < polybench_region_nb_counters; ++t)
+	fprintf (stderr, " %lld", reg->counters[t]);
+      fprintf (stderr, "\n");
+      polybench_region_print_tree (r, depth + 1, max);
+    }
+}
+
+
+/*
+ * Print the region tree on stderr. Time is the maximal time spent in
+ * the region by a thread, cpu the sum over the threads, and %parent
+ * is relative to the time of the enclosing region.
+ */
+static
+void polybench_region_print()
+{
+  if (polybench_nb_regions == 0)
+    return;
+  fprintf (stderr, "[PolyBench] %-32s %10s %12s %12s %4s %6s %7s",
+	   "region", "calls", "time", "cpu", "thr", "imbal", "%parent");
+# ifdef POLYBENCH_PERF
+  int k;
+  for (k = 0; k < polybench_region_nb_counters; ++k)
+    fprintf (stderr, " %s", _polybench_perf_eventlist[k]);
+# endif
+  fprintf (stderr, "\n");
+  polybench_region_print_tree (-1, 0, 0);
+}
+
+
+void polybench_regions_reset()
+{
+  int r;
+
+  for (r = 0; r < polybench_nb_regions; ++r)
+    {
+      memset (polybench_regions[r].time, 0, sizeof(polybench_regions[r].time));
+      memset (polybench_regions[r].calls, 0,
+	      sizeof(polybench_regions[r].calls));
+      memset (polybench_regions[r].counters, 0,
+	      sizeof(polybench_regions[r].counters));
+    }
+}
+
+
+void polybench_region_enter(const char* name)
+{
+  int parent = -1, r, d;
+  struct polybench_region_frame* frame;
+
+  if (polybench_region_depth == POLYBENCH_MAX_REGION_DEPTH)
+    {
+      fprintf (stderr, "[PolyBench] Regions nested too deeply, "
+	       "increase POLYBENCH_MAX_REGION_DEPTH\n");
+      exit (1);
+    }
+  frame = &polybench_region_stack[polybench_region_depth++];
+  /* Fold recursive entries into the active region. */
+  for (d = polybench_region_depth - 2; d >= 0; --d)
+    if (! strcmp (polybench_regions[polybench_region_stack[d].region].name,
+		  name))
+      {
+	frame->region = polybench_region_stack[d].region;
+	frame->folded = 1;
+	return;
+      }
+  if (polybench_region_depth > 1)
+    parent = polybench_region_stack[polybench_region_depth - 2].region;
+  else if (! polybench_region_serial ())
+    parent = polybench_region_current;
+  if ((r = polybench_region_lookup (parent, name)) == -1)
+    {
+#pragma omp critical (polybench_region)
+      {
+	if ((r = polybench_region_lookup (parent, name)) == -1)
+	  {
+	    if (polybench_nb_regions == POLYBENCH_MAX_NB_REGIONS)
+	      {
+		fprintf (stderr, "[PolyBench] Too many regions, "
+			 "increase POLYBENCH_MAX_NB_REGIONS\n");
+		exit (1);
+	      }
+	    if (! polybench_region_print_registered++)
+	      atexit (polybench_region_print);
+	    r = polybench_nb_regions;
+	    polybench_regions[r].name = name;
+	    polybench_regions[r].parent = parent;
+#pragma omp flush
+	    polybench_nb_regions++;
+	  }
+      }
+    }
+  frame->region = r;
+  frame->folded = 0;
+  frame->all_threads = polybench_region_serial ();
+  if (frame->all_threads)
+    polybench_region_current = r;
+# ifdef POLYBENCH_PERF
+  if (polybench_perf_initialized)
+    polybench_region_nb_counters =
+      polybench_perf_nb_events < POLYBENCH_MAX_NB_REGION_COUNTERS ?
+      polybench_perf_nb_events : POLYBENCH_MAX_NB_REGION_COUNTERS;
+  polybench_region_read_counters (polybench_region_thread_id (),
+				  frame->all_threads, frame->counters);
+# endif
+  frame->start = rtclock ();
+}
+
+
+void polybench_region_exit(const char* name)
+{
+  double end = rtclock ();
+  struct polybench_region_frame* frame;
+  int tid;
+
+  if (polybench_region_depth == 0
+      || strcmp (polybench_regions[polybench_region_stack[polybench_region_depth - 1].region].name, name))
+    {
+      fprintf (stderr, "[PolyBench] Unbalanced region end: %s\n", name);
+      exit (1);
+    }
+  frame = &polybench_region_stack[--polybench_region_depth];
+  if (frame->folded)
+    return;
+  if (frame->all_threads)
+    polybench_region_current = polybench_region_depth > 0 ?
+      polybench_region_stack[polybench_region_depth - 1].region : -1;
+  tid = polybench_region_thread_id ();
+  polybench_regions[frame->region].time[tid] += end - frame->start;
+  polybench_regions[frame->region].calls[tid]++;
+# ifdef POLYBENCH_PERF
+  long long values[POLYBENCH_MAX_NB_REGION_COUNTERS];
+  if (polybench_region_read_counters (tid, frame->all_threads, values))
+    {
+      int k;
+      for (k = 0; k < polybench_region_nb_counters; ++k)
+	{
+#pragma omp atomic
+	  polybench_regions[frame->region].counters[k] +=
+	    values[k] - frame->counters[k];
+	}
+    }
+# endif
+}
+
+#endif
+/* ! POLYBENCH_REGIONS */
+
+void polybench_prepare_instruments()
+{
+#ifdef POLYBENCH_AFFINITY
+  polybench_affinity_apply ();
+#endif
+#ifdef POLYBENCH_NUMA
+  static int placement_reported = 0;
+  if (! placement_reported++)
+    polybench_print_numa_placement ();
+#endif
+#ifndef POLYBENCH_NO_FLUSH_CACHE
+  polybench_flush_cache ();
+#endif
+#ifdef POLYBENCH_LINUX_FIFO_SCHEDULER
+  polybench_linux_fifo_scheduler ();
+#endif
+#if defined(POLYBENCH_AFFINITY) || defined(POLYBENCH_RECORD)
+  polybench_sample_thread_cpus ();
+#endif
+}
+
+
+#if defined(POLYBENCH_ROOFLINE) || defined(POLYBENCH_RECORD)
+/* Model name of the host CPU, from /proc/cpuinfo. */
+static
+void polybench_cpu_model(char* model, size_t sz)
+{
+  FILE* f = fopen ("/proc/cpuinfo", "r");
+  char line[4096];
+
+  snprintf (model, sz, "unknown");
+  if (f == NULL)
+    return;
+  while (fgets (line, sizeof(line), f) != NULL)
+    if (strncmp (line, "model name", 10) == 0 && strchr (line, ':'))
+      {
+	char* p = strchr (line, ':') + 1;
+	while (*p == ' ')
+	  p++;
+	p[strcspn (p, "\n")] = '\0';
+	snprintf (model, sz, "%s", p);
+	break;
+      }
+  fclose (f);
+}
+#endif
+
+
+#ifdef POLYBENCH_ROOFLINE
+/*
+ * Roofline characterization of the host: sustained triad bandwidth of
+ * the L2, the L3 and the DRAM, and peak FMA throughput of the scalar,
+ * AVX2 and AVX-512 paths, measured with all the OpenMP threads. The
+ * results are cached in POLYBENCH_ROOFLINE_FILE [default:
+ * $HOME/.polybench_roofline], one line per CPU model and thread count.
+ */
+# if defined(__x86_64__) || defined(__i386__)
+#  include <immintrin.h>
+#  define POLYBENCH_HAVE_X86_FMA
+# endif
+/* Cap of the DRAM triad working set, in MB. */
+# ifndef POLYBENCH_ROOFLINE_MAX_MB
+#  define POLYBENCH_ROOFLINE_MAX_MB 512
+# endif
+# define POLYBENCH_FMA_ITERS (1 << 24)
+
+struct polybench_roofline
+{
+  int nb_threads;
+  double dram_bw, l3_bw, l2_bw;
+  double scalar_peak, avx2_peak, avx512_peak;
+  char cpu_model[256];
+};
+
+static struct polybench_roofline polybench_machine;
+
+
+/* Twelve independent chains hide the latency of the FMA units. */
+# define POLYBENCH_FMA_CHAINS(fma)					\
+  x0 = fma (x0, m, a); x1 = fma (x1, m, a); x2 = fma (x2, m, a);	\
+  x3 = fma (x3, m, a); x4 = fma (x4, m, a); x5 = fma (x5, m, a);	\
+  x6 = fma (x6, m, a); x7 = fma (x7, m, a); x8 = fma (x8, m, a);	\
+  x9 = fma (x9, m, a); x10 = fma (x10, m, a); x11 = fma (x11, m, a);
+# define POLYBENCH_FMA_LOOP(type, set1, fma, add, cvt)		\
+  type m = set1 (0.999999), a = set1 (1e-6);				\
+  type x0 = set1 (1.0), x1 = x0, x2 = x0, x3 = x0, x4 = x0, x5 = x0;	\
+  type x6 = x0, x7 = x0, x8 = x0, x9 = x0, x10 = x0, x11 = x0;	\
+  long i;								\
+  for (i = 0; i < POLYBENCH_FMA_ITERS; i++)				\
+    {									\
+      POLYBENCH_FMA_CHAINS(fma)						\
+    }									\
+  x0 = add (add (add (x0, x1), add (x2, x3)), add (x4, x5));		\
+  x6 = add (add (add (x6, x7), add (x8, x9)), add (x10, x11));		\
+  return cvt (add (x0, x6));
+
+# ifdef POLYBENCH_HAVE_X86_FMA
+__attribute__((target("fma")))
+static
+double polybench_fma_scalar()
+{
+  POLYBENCH_FMA_LOOP(__m128d, _mm_set_sd, _mm_fmadd_sd, _mm_add_sd, _mm_cvtsd_f64)
+}
+
+__attribute__((target("avx2,fma")))
+static
+double polybench_fma_avx2()
+{
+  POLYBENCH_FMA_LOOP(__m256d, _mm256_set1_pd, _mm256_fmadd_pd, _mm256_add_pd,
+		     _mm256_cvtsd_f64)
+}
+
+__attribute__((target("avx512f")))
+static
+double polybench_fma_avx512()
+{
+  POLYBENCH_FMA_LOOP(__m512d, _mm512_set1_pd, _mm512_fmadd_pd, _mm512_add_pd,
+		     _mm512_cvtsd_f64)
+}
+# endif
+
+
+/*
+ * Peak FMA throughput in GFLOP/s, using WIDTH-wide vectors (1 for
+ * scalar), on all the threads. Returns 0 if the CPU lacks the path.
+ */
+static
+double polybench_measure_fma_peak(int width)
+{
+  double best = 0;
+  int trial;
+
+# ifdef POLYBENCH_HAVE_X86_FMA
+  __builtin_cpu_init ();
+  if ((width == 1 && ! __builtin_cpu_supports ("fma"))
+      || (width == 4 && ! (__builtin_cpu_supports ("avx2")
+			   && __builtin_cpu_supports ("fma")))
+      || (width == 8 && ! __builtin_cpu_supports ("avx512f")))
+    return 0;
+# else
+  return 0;
+# endif
+  for (trial = 0; trial < 3; trial++)
+    {
+      double sink = 0;
+      double t0 = rtclock ();
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:sink)
+#endif
+      {
+# ifdef POLYBENCH_HAVE_X86_FMA
+	if (width == 1)
+	  sink += polybench_fma_scalar ();
+	else if (width == 4)
+	  sink += polybench_fma_avx2 ();
+	else
+	  sink += polybench_fma_avx512 ();
+# endif
+      }
+      double t = rtclock () - t0;
+      double flops = 2.0 * 12 * width * (double) POLYBENCH_FMA_ITERS
+	* polybench_machine.nb_threads;
+      if (sink != 0 && t > 0 && flops / t / 1e9 > best)
+	best = flops / t / 1e9;
+    }
+
+  return best;
+}
+
+
+/*
+ * STREAM triad a = b + s * c on three arrays of N elements carved out
+ * of the flush buffer. Returns the best bandwidth in GB/s, counting 24
+ * bytes per element as STREAM does.
+ */
+static
+double polybench_measure_triad(size_t n)
+{
+  double* buf = polybench_get_flush_buffer (3 * n);
+  double* a = buf;
+  double* b = buf + n;
+  double* c = buf + 2 * n;
+  double best = 0;
+  long i, reps = 1e9 / (24.0 * n);
+  int trial;
+
+  if (reps < 2)
+    reps = 2;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+  for (i = 0; i < (long) n; i++)
+    {
+      b[i] = 1.0;
+      c[i] = 2.0;
+    }
+  for (trial = 0; trial < 3; trial++)
+    {
+      double t0 = rtclock ();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+      {
+	long r, j;
+	for (r = 0; r < reps; r++)
+	  {
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+	    for (j = 0; j < (long) n; j++)
+	      a[j] = b[j] + 3.0 * c[j];
+	  }
+      }
+      double t = rtclock () - t0;
+      if (t > 0 && 24.0 * n * reps / t / 1e9 > best)
+	best = 24.0 * n * reps / t / 1e9;
+    }
+  /* polybench_flush_cache expects a zero-filled buffer. */
+  memset (buf, 0, 3 * n * sizeof(double));
+
+  return best;
+}
+
+
+static
+void polybench_measure_machine()
+{
+  long l2 = sysconf (_SC_LEVEL2_CACHE_SIZE);
+  long l3 = sysconf (_SC_LEVEL3_CACHE_SIZE);
+  double dram = 4.0 * polybench_cache_capacity ();
+  int nt = polybench_machine.nb_threads;
+
+  fprintf (stderr, "[PolyBench] Measuring the roofline of this machine"
+	   " (%d threads)...\n", nt);
+  if (l3 > 0 && 4.0 * l3 > dram)
+    dram = 4.0 * l3;
+  if (dram > POLYBENCH_ROOFLINE_MAX_MB * 1024.0 * 1024)
+    dram = POLYBENCH_ROOFLINE_MAX_MB * 1024.0 * 1024;
+  /* Half of the private L2 per thread, half of the shared L3. */
+  polybench_machine.l2_bw =
+    l2 > 0 ? polybench_measure_triad ((size_t) nt * l2 / 2 / 24) : 0;
+  polybench_machine.l3_bw =
+    l3 > 0 && l3 / 2 < dram ? polybench_measure_triad (l3 / 2 / 24) : 0;
+  polybench_machine.dram_bw = polybench_measure_triad (dram / 24);
+  polybench_machine.scalar_peak = polybench_measure_fma_peak (1);
+  polybench_machine.avx2_peak = polybench_measure_fma_peak (4);
+  polybench_machine.avx512_peak = polybench_measure_fma_peak (8);
+}
+
+
+static
+void polybench_roofline_file(char* path, size_t sz)
+{
+  const char* file = getenv ("POLYBENCH_ROOFLINE_FILE");
+  const char* home = getenv ("HOME");
+
+  if (file != NULL)
+    snprintf (path, sz, "%s", file);
+  else if (home != NULL)
+    snprintf (path, sz, "%s/.polybench_roofline", home);
+  else
+    snprintf (path, sz, ".polybench_roofline");
+}
+
+
+/* Load the characterization of the machine from the cache, or measure
+   it and append it to the cache. */
+static
+void polybench_load_roofline()
+{
+  static int loaded = 0;
+  char path[4096], line[4096], model[256];
+  struct polybench_roofline r;
+  FILE* f;
+
+  if (loaded)
+    return;
+  loaded = 1;
+#ifdef _OPENMP
+  polybench_machine.nb_threads = omp_get_max_threads ();
+#else
+  polybench_machine.nb_threads = 1;
+#endif
+  polybench_cpu_model (polybench_machine.cpu_model,
+		       sizeof(polybench_machine.cpu_model));
+  polybench_roofline_file (path, sizeof(path));
+  if ((f = fopen (path, "r")) != NULL)
+    {
+      while (fgets (line, sizeof(line), f) != NULL)
+	if (sscanf (line, "%d %lf %lf %lf %lf %lf %lf %255[^\n]",
+		    &r.nb_threads, &r.dram_bw, &r.l3_bw, &r.l2_bw,
+		    &r.scalar_peak, &r.avx2_peak, &r.avx512_peak, model) == 8
+	    && r.nb_threads == polybench_machine.nb_threads
+	    && ! strcmp (model, polybench_machine.cpu_model))
+	  {
+	    strcpy (r.cpu_model, model);
+	    polybench_machine = r;
+	    fclose (f);
+	    return;
+	  }
+      fclose (f);
+    }
+  polybench_measure_machine ();
+  if ((f = fopen (path, "a")) != NULL)
+    {
+      fprintf (f, "%d %0.3f %0.3f %0.3f %0.3f %0.3f %0.3f %s\n",
+	       polybench_machine.nb_threads, polybench_machine.dram_bw,
+	       polybench_machine.l3_bw, polybench_machine.l2_bw,
+	       polybench_machine.scalar_peak, polybench_machine.avx2_peak,
+	       polybench_machine.avx512_peak, polybench_machine.cpu_model);
+      fclose (f);
+    }
+  else
+    fprintf (stderr, "[PolyBench][WARNING] Cannot write %s\n", path);
+}
+
+
+/*
+ * Memory roof for a working set of BYTES: the bandwidth of the smallest
+ * level which holds it, as measured by polybench_measure_machine (half
+ * of the L2 per thread, half of the L3), or of the DRAM. The caches are
+ * only considered when they are not flushed before the kernel, as the
+ * minimal traffic then comes from the DRAM.
+ */
+static
+double polybench_roofline_memory_bw(double bytes, const char** level)
+{
+#ifdef POLYBENCH_NO_FLUSH_CACHE
+  long l2 = sysconf (_SC_LEVEL2_CACHE_SIZE);
+  long l3 = sysconf (_SC_LEVEL3_CACHE_SIZE);
+
+  if (polybench_machine.l2_bw > 0 && l2 > 0
+      && bytes <= (double) polybench_machine.nb_threads * l2 / 2)
+    {
+      *level = "l2";
+      return polybench_machine.l2_bw;
+    }
+  if (polybench_machine.l3_bw > 0 && l3 > 0 && bytes <= l3 / 2.0)
+    {
+      *level = "l3";
+      return polybench_machine.l3_bw;
+    }
+#else
+  (void) bytes;
+#endif
+  *level = "dram";
+  return polybench_machine.dram_bw;
+}
+
+
+/*
+ * Report the attained performance against the roofline bound for the
+ * arithmetic intensity of the kernel. The compute roof is the peak of
+ * the widest FMA path the program was compiled for, the memory roof the
+ * bandwidth of the level which holds the working set of the model.
+ */
+static
+void polybench_print_roofline(double flops, double bytes, double elapsed)
+{
+  const char* isa;
+  const char* level;
+  double peak, bound, ridge, bw;
+  double intensity = bytes > 0 ? flops / bytes : 0;
+  double gflops = flops / elapsed / 1e9;
+  double gbs = bytes / elapsed / 1e9;
+
+  polybench_load_roofline ();
+#if defined(__AVX512F__)
+  isa = "avx512";
+  peak = polybench_machine.avx512_peak;
+#elif defined(__AVX2__) && defined(__FMA__)
+  isa = "avx2";
+  peak = polybench_machine.avx2_peak;
+#else
+  isa = "scalar";
+  peak = polybench_machine.scalar_peak;
+#endif
+  if (peak == 0)
+    {
+      isa = "scalar";
+      peak = polybench_machine.scalar_peak;
+    }
+  bw = polybench_roofline_memory_bw (bytes, &level);
+  ridge = bw > 0 ? peak / bw : 0;
+  bound = intensity * bw;
+  if (bound > peak || bound == 0)
+    bound = peak;
+  printf ("[PolyBench] roofline: peak=%0.1f GFLOP/s (%s, %d threads)"
+	  " dram=%0.1f GB/s l3=%0.1f GB/s l2=%0.1f GB/s\n",
+	  peak, isa, polybench_machine.nb_threads, polybench_machine.dram_bw,
+	  polybench_machine.l3_bw, polybench_machine.l2_bw);
+  printf ("[PolyBench] roofline: intensity=%0.3f ridge=%0.3f flop/byte"
+	  " (%s) => %s-bound, bound=%0.1f GFLOP/s\n",
+	  intensity, ridge, level, intensity < ridge ? "memory" : "compute",
+	  bound);
+  printf ("[PolyBench] roofline: efficiency=%0.1f%% of bound, %0.1f%% of peak,"
+	  " %0.1f%% of %s bandwidth\n",
+	  bound > 0 ? gflops / bound * 100 : 0.0,
+	  peak > 0 ? gflops / peak * 100 : 0.0,
+	  bw > 0 ? gbs / bw * 100 : 0.0, level);
+}
+#endif
+/* ! POLYBENCH_ROOFLINE */
+
+
+/* Set the analytic model of the kernel, unless set by the kernel. */
+void polybench_set_program_model(double flops, double bytes)
+{
+  if (polybench_program_total_flops == 0)
+    polybench_program_total_flops = flops;
+  if (polybench_program_total_bytes == 0)
+    polybench_program_total_bytes = bytes;
+}
+
+
+/*
+ * Report the analytic model of the kernel, and the performance it
+ * implies for a run of ELAPSED seconds (or cycles).
+ */
+static
+void polybench_print_program_model(double elapsed)
+{
+  double flops = polybench_program_total_flops;
+  double bytes = polybench_program_total_bytes;
+
+  printf ("[PolyBench] flops=%0.0f bytes=%0.0f intensity=%0.3f flop/byte\n",
+	  flops, bytes, bytes > 0 ? flops / bytes : 0.0);
+  if (elapsed <= 0)
+    return;
+#ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
+  printf ("[PolyBench] performance=%0.3f GFLOP/s bandwidth=%0.3f GB/s\n",
+	  flops / elapsed / 1e9, bytes / elapsed / 1e9);
+# ifdef POLYBENCH_ROOFLINE
+  polybench_print_roofline (flops, bytes, elapsed);
+# endif
+#else
+  printf ("[PolyBench] performance=%0.3f flop/cycle bandwidth=%0.3f byte/cycle\n",
+	  flops / elapsed, bytes / elapsed);
+#endif
+#ifdef COUNT_FLOPS
+  printf ("[PolyBench] counted flops=%llu (%0.2f%% of the model)\n",
+	  polybench_flop_counter,
+	  flops > 0 ? polybench_flop_counter / flops * 100 : 0.0);
+#endif
+}
+
+
+void polybench_timer_start()
+{
+#ifdef COUNT_FLOPS
+  polybench_flop_counter = 0;
+#endif
+#ifdef POLYBENCH_REGIONS
+  /* Profile only the timed runs. */
+  if (POLYBENCH_WARMUP_RUNS > 0 && polybench_nb_samples == POLYBENCH_WARMUP_RUNS)
+    polybench_regions_reset ();
+#endif
+  polybench_timer_calibrate ();
+  polybench_prepare_instruments ();
+#ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
+  polybench_t_start = rtclock ();
+#else
+  polybench_c_start = rdtsc ();
+#endif
+}
+
+
+void polybench_timer_stop()
+{
+#ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
+  polybench_t_end = rtclock ();
+#else
+  polybench_c_end = rdtscp ();
+#endif
+#ifdef POLYBENCH_LINUX_FIFO_SCHEDULER
+  polybench_linux_standard_scheduler ();
+#endif
+  if (polybench_nb_samples < POLYBENCH_TOTAL_NB_RUNS)
+    {
+#ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
+      polybench_run_samples[polybench_nb_samples++] =
+	polybench_t_end - polybench_t_start;
+#else
+      polybench_run_samples[polybench_nb_samples++] =
+	(double)(polybench_c_end - polybench_c_start);
+#endif
+    }
+}
+
+
+#if POLYBENCH_NB_RUNS + POLYBENCH_WARMUP_RUNS > 1 || defined(POLYBENCH_RECORD)
+struct polybench_run_stats
+{
+  int nb;
+  double min, median, mean, stddev, cv;
+};
+
+
+static
+int compare_samples(const void* a, const void* b)
+{
+  double x = *(const double*)a;
+  double y = *(const double*)b;
+
+  return (x > y) - (x < y);
+}
+
+
+/*
+ * Summarize the runs recorded by polybench_timer_stop, excluding the
+ * warm-up runs. The median is the value reported as the program
+ * execution time.
+ */
+static
+void polybench_run_statistics(struct polybench_run_stats* st)
+{
+  double samples[POLYBENCH_TOTAL_NB_RUNS];
+  int nb = polybench_nb_samples - POLYBENCH_WARMUP_RUNS;
+  double mean = 0.0, var = 0.0;
+  int i;
+
+  memset (st, 0, sizeof(struct polybench_run_stats));
+  if (nb <= 0)
+    return;
+  memcpy (samples, polybench_run_samples + POLYBENCH_WARMUP_RUNS,
+	  nb * sizeof(double));
+  qsort (samples, nb, sizeof(double), compare_samples);
+  for (i = 0; i < nb; i++)
+    mean += samples[i];
+  mean /= nb;
+  for (i = 0; i < nb; i++)
+    var += (samples[i] - mean) * (samples[i] - mean);
+  var = nb > 1 ? var / (nb - 1) : 0.0;
+  st->nb = nb;
+  st->min = samples[0];
+  if (nb % 2)
+    st->median = samples[nb / 2];
+  else
+    st->median = (samples[nb / 2 - 1] + samples[nb / 2]) / 2;
+  st->mean = mean;
+  st->stddev = sqrt (var);
+  st->cv = mean > 0 ? st->stddev / mean * 100 : 0.0;
+}
+#endif
+
+
+#if POLYBENCH_NB_RUNS + POLYBENCH_WARMUP_RUNS > 1
+static
+double polybench_print_run_statistics()
+{
+  struct polybench_run_stats st;
+
+  polybench_run_statistics (&st);
+#ifndef POLYBENCH_NO_FLUSH_CACHE
+  if (polybench_flush_method != NULL)
+    printf ("[PolyBench] runs=%d warmup=%d cache=cold flush=%s\n",
+	    st.nb, POLYBENCH_WARMUP_RUNS, polybench_flush_method);
+  else
+    printf ("[PolyBench] runs=%d warmup=%d cache=cold flush=%luKB\n",
+	    st.nb, POLYBENCH_WARMUP_RUNS,
+	    (unsigned long) (polybench_flush_size () * sizeof(double) / 1024));
+#else
+  printf ("[PolyBench] runs=%d warmup=%d cache=hot\n",
+	  st.nb, POLYBENCH_WARMUP_RUNS);
+#endif
+  printf ("[PolyBench] min=%0.6f median=%0.6f mean=%0.6f stddev=%0.6f cv=%0.2f%%\n",
+	  st.min, st.median, st.mean, st.stddev, st.cv);
+  if (st.cv >= POLYBENCH_VARIANCE_THRESHOLD)
+    {
+      printf ("[WARNING] Variance is above threshold, unsafe performance measurement\n");
+      printf ("        => cv=%0.2f%%, tolerance=%g%%\n",
+	      st.cv, (double) POLYBENCH_VARIANCE_THRESHOLD);
+    }
+  else
+    printf ("[INFO] Coefficient of variation: %0.2f%%, tolerance=%g%%\n",
+	    st.cv, (double) POLYBENCH_VARIANCE_THRESHOLD);
+
+  return st.median;
+}
+#endif
+
+
+#if defined(POLYBENCH_AFFINITY) || defined(POLYBENCH_RECORD)
+/*
+ * Topology of the CPUs the process may run on (its affinity mask at
+ * the first call, i.e. the cpuset of the job), from
+ * /sys/devices/system/cpu: the package, the L3 domain (core complex,
+ * or CCX, on AMD processors; the package when there is no L3) and the
+ * core of each CPU. The CPUs are kept in compact order: package, L3
+ * domain, core, then SMT sibling.
+ */
+struct polybench_cpu
+{
+  int cpu, package, l3, core, smt;
+  /* Rank of the L3 domain in the package, of the core in the domain. */
+  int l3_rank, core_rank;
+  int key[4];
+};
+
+/* Fields of polybench_cpu, as sort keys. */
+# define POLYBENCH_CPU_PACKAGE 0
+# define POLYBENCH_CPU_L3 1
+# define POLYBENCH_CPU_CORE 2
+# define POLYBENCH_CPU_SMT 3
+# define POLYBENCH_CPU_L3_RANK 4
+# define POLYBENCH_CPU_CORE_RANK 5
+
+static struct polybench_cpu polybench_cpus[CPU_SETSIZE];
+static int polybench_nb_cpus = 0;
+static int polybench_nb_packages, polybench_nb_l3, polybench_nb_cores;
+
+/* CPU of each thread at the last sample, and the number of changes. */
+static int polybench_thread_cpus[POLYBENCH_MAX_NB_THREADS];
+static int polybench_nb_thread_cpus = 0;
+static int polybench_thread_migrations = 0;
+
+
+static
+int polybench_read_topology_attr(int cpu, const char* attr)
+{
+  char path[256];
+  int value = -1;
+  FILE* f;
+
+  snprintf (path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/%s",
+	    cpu, attr);
+  if ((f = fopen (path, "r")) == NULL)
+    return -1;
+  if (fscanf (f, "%d", &value) != 1)
+    value = -1;
+  fclose (f);
+
+  return value;
+}
+
+
+static
+int polybench_compare_cpus(const void* a, const void* b)
+{
+  const struct polybench_cpu* x = (const struct polybench_cpu*) a;
+  const struct polybench_cpu* y = (const struct polybench_cpu*) b;
+  int k;
+
+  for (k = 0; k < 4; ++k)
+    if (x->key[k] != y->key[k])
+      return x->key[k] < y->key[k] ? -1 : 1;
+  return x->cpu - y->cpu;
+}
+
+
+/* Sort the CPUs on the keys K0..K3 (-1 for none). */
+static
+void polybench_sort_cpus(int k0, int k1, int k2, int k3)
+{
+  int i, k, fields[4];
+
+  fields[0] = k0, fields[1] = k1, fields[2] = k2, fields[3] = k3;
+  for (i = 0; i < polybench_nb_cpus; ++i)
+    {
+      struct polybench_cpu* c = &polybench_cpus[i];
+      int values[7];
+      values[0] = c->package, values[1] = c->l3, values[2] = c->core;
+      values[3] = c->smt, values[4] = c->l3_rank, values[5] = c->core_rank;
+      values[6] = 0;
+      for (k = 0; k < 4; ++k)
+	c->key[k] = values[fields[k] < 0 ? 6 : fields[k]];
+    }
+  qsort (polybench_cpus, polybench_nb_cpus, sizeof(struct polybench_cpu),
+	 polybench_compare_cpus);
+}
+
+
+/* Ranks, SMT index and counts, from the CPUs in compact order. */
+static
+void polybench_rank_cpus()
+{
+  int i;
+
+  polybench_nb_packages = polybench_nb_l3 = polybench_nb_cores = 0;
+  for (i = 0; i < polybench_nb_cpus; ++i)
+    {
+      struct polybench_cpu* c = &polybench_cpus[i];
+      struct polybench_cpu* p = i > 0 ? &polybench_cpus[i - 1] : NULL;
+      int new_package = p == NULL || p->package != c->package;
+      int new_l3 = new_package || p->l3 != c->l3;
+      int new_core = new_l3 || p->core != c->core;
+      polybench_nb_packages += new_package;
+      polybench_nb_l3 += new_l3;
+      polybench_nb_cores += new_core;
+      c->l3_rank = new_package ? 0 : p->l3_rank + new_l3;
+      c->core_rank = new_l3 ? 0 : p->core_rank + new_core;
+      c->smt = new_core ? 0 : p->smt + 1;
+    }
+}
+
+
+static
+void polybench_read_topology()
+{
+  cpu_set_t set;
+  char buf[256];
+  int cpu, idx;
+
+  if (polybench_nb_cpus > 0)
+    return;
+  CPU_ZERO (&set);
+  if (sched_getaffinity (0, sizeof(set), &set) != 0)
+    CPU_SET (sched_getcpu () >= 0 ? sched_getcpu () : 0, &set);
+  for (cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      struct polybench_cpu* c = &polybench_cpus[polybench_nb_cpus];
+      if (! CPU_ISSET (cpu, &set))
+	continue;
+      c->cpu = cpu;
+      c->package = polybench_read_topology_attr (cpu, "physical_package_id");
+      c->core = polybench_read_topology_attr (cpu, "core_id");
+      if (c->core < 0)
+	c->core = cpu;
+      c->l3 = -1;
+      for (idx = 0; polybench_read_cache_attr (cpu, idx, "level",
+					       buf, sizeof(buf)); ++idx)
+	if (atoi (buf) == 3
+	    && polybench_read_cache_attr (cpu, idx, "shared_cpu_list",
+					  buf, sizeof(buf)))
+	  c->l3 = atoi (buf);
+      polybench_nb_cpus++;
+    }
+  polybench_sort_cpus (POLYBENCH_CPU_PACKAGE, POLYBENCH_CPU_L3,
+		       POLYBENCH_CPU_CORE, -1);
+  polybench_rank_cpus ();
+}
+
+
+/* Print the list of the CPUs of SET, e.g. 0-3,8, to BUF. */
+static
+void polybench_format_cpu_set(cpu_set_t* set, char* buf, size_t sz)
+{
+  int cpu, first = -1;
+  size_t len = 0;
+
+  buf[0] = '\0';
+  for (cpu = 0; cpu <= CPU_SETSIZE; ++cpu)
+    {
+      int in = cpu < CPU_SETSIZE && CPU_ISSET (cpu, set);
+      if (in && first < 0)
+	first = cpu;
+      if (! in && first >= 0 && len < sz)
+	{
+	  len += snprintf (buf + len, sz - len, "%s%d", len ? "," : "", first);
+	  if (cpu - 1 > first && len < sz)
+	    len += snprintf (buf + len, sz - len, "-%d", cpu - 1);
+	  first = -1;
+	}
+    }
+}
+
+
+/* Current CPU set of the process, e.g. 0-3,8. */
+static
+void polybench_cpu_set_string(char* buf, size_t sz)
+{
+  cpu_set_t set;
+
+  CPU_ZERO (&set);
+  if (sched_getaffinity (0, sizeof(set), &set) != 0)
+    buf[0] = '\0';
+  else
+    polybench_format_cpu_set (&set, buf, sz);
+}
+
+
+/* Record the CPU each thread runs on, and count the changes since the
+   previous sample. */
+static
+void polybench_sample_thread_cpus()
+{
+  int cpus[POLYBENCH_MAX_NB_THREADS];
+  int nb = 1, t;
+
+  cpus[0] = sched_getcpu ();
+#ifdef _OPENMP
+#pragma omp parallel
+  {
+    int tid = omp_get_thread_num ();
+    if (tid < POLYBENCH_MAX_NB_THREADS)
+      cpus[tid] = sched_getcpu ();
+#pragma omp master
+    nb = omp_get_num_threads () < POLYBENCH_MAX_NB_THREADS ?
+      omp_get_num_threads () : POLYBENCH_MAX_NB_THREADS;
+  }
+#endif
+  for (t = 0; t < nb; ++t)
+    {
+      if (t < polybench_nb_thread_cpus && polybench_thread_cpus[t] != cpus[t])
+	polybench_thread_migrations++;
+      polybench_thread_cpus[t] = cpus[t];
+    }
+  polybench_nb_thread_cpus = nb;
+}
+#endif
+
+
+#ifdef POLYBENCH_RECORD
+/*
+ * Result records. Each execution appends to the file named by the
+ * POLYBENCH_RECORD_FILE environment variable [default: polybench.jsonl
+ * or polybench.csv] either one JSON object per line
+ * (POLYBENCH_RECORD_JSON), or one CSV row per timed run
+ * (POLYBENCH_RECORD_CSV) whose first five columns are those of
+ * final-plotting/data.csv.
+ */
+# include <stdarg.h>
+# define POLYBENCH_MAX_NB_SIZES 16
+/* Compilation flags, which the build may provide, e.g.
+   -DPOLYBENCH_CFLAGS="\"$(CFLAGS)\"". */
+# ifndef POLYBENCH_CFLAGS
+#  define POLYBENCH_CFLAGS ""
+# endif
+# if defined(__clang__)
+#  define POLYBENCH_COMPILER "clang " __clang_version__
+# elif defined(__INTEL_COMPILER)
+#  define POLYBENCH_COMPILER "icc " __VERSION__
+# elif defined(__GNUC__)
+#  define POLYBENCH_COMPILER "gcc " __VERSION__
+# else
+#  define POLYBENCH_COMPILER "unknown"
+# endif
+
+/* Code generation options visible to the preprocessor. */
+static const char polybench_build_features[] = ""
+# ifdef __OPTIMIZE__
+  " optimize"
+# endif
+# ifdef __FAST_MATH__
+  " fast-math"
+# endif
+# ifdef _OPENMP
+  " openmp"
+# endif
+# ifdef __FMA__
+  " fma"
+# endif
+# ifdef __AVX2__
+  " avx2"
+# endif
+# ifdef __AVX512F__
+  " avx512f"
+# endif
+  ;
+
+static const char* polybench_program_file = NULL;
+static const char* polybench_program_kernel = NULL;
+static const char* polybench_program_data_type = "";
+static const char* polybench_size_names[POLYBENCH_MAX_NB_SIZES];
+static int polybench_size_values[POLYBENCH_MAX_NB_SIZES];
+static int polybench_nb_sizes = 0;
+
+
+/* Called by polybench_start_instruments, with the POLYBENCH_KERNEL_NAME
+   of the kernel header and a NULL-terminated list of (name, value) pairs
+   for the problem sizes. */
+void polybench_set_program_info(const char* file, const char* kernel,
+				const char* data_type, ...)
+{
+  va_list ap;
+  const char* name;
+
+  if (polybench_program_file != NULL)
+    return;
+  polybench_program_file = file;
+  polybench_program_kernel = kernel;
+  polybench_program_data_type = data_type;
+  va_start (ap, data_type);
+  while ((name = va_arg (ap, const char*)) != NULL
+	 && polybench_nb_sizes < POLYBENCH_MAX_NB_SIZES)
+    {
+      polybench_size_names[polybench_nb_sizes] = name;
+      polybench_size_values[polybench_nb_sizes++] = va_arg (ap, int);
+    }
+  va_end (ap);
+}
+
+
+/*
+ * Split the path of the kernel source, e.g.
+ * linear-algebra/solvers/ludcmp/ludcmp-blocking-openmp-fma.c, into the
+ * program name (ludcmp-blocking-openmp-fma), the kernel (ludcmp, given
+ * by the kernel header, or else the name of the directory) and the
+ * variant (blocking-openmp-fma, or reference for the original
+ * implementation). The variant is empty when the kernel is unknown.
+ */
+static
+void polybench_program_names(char* name, char* kernel, char* variant,
+			     size_t sz)
+{
+  const char* path = polybench_program_file ? polybench_program_file : "";
+  const char* base = strrchr (path, '/');
+  size_t len;
+
+  base = base ? base + 1 : path;
+  snprintf (name, sz, "%s", base);
+  if (strrchr (name, '.'))
+    *strrchr (name, '.') = '\0';
+  if (polybench_program_kernel != NULL)
+    snprintf (kernel, sz, "%s", polybench_program_kernel);
+  else if (base != path)
+    {
+      const char* dir = base - 1;
+      while (dir > path && dir[-1] != '/')
+	dir--;
+      snprintf (kernel, sz, "%.*s", (int) (base - 1 - dir), dir);
+    }
+  else
+    {
+      snprintf (kernel, sz, "%s", name);
+      variant[0] = '\0';
+      return;
+    }
+  len = strlen (kernel);
+  if (! strcmp (name, kernel))
+    snprintf (variant, sz, "reference");
+  else if (! strncmp (name, kernel, len) && name[len] == '-')
+    snprintf (variant, sz, "%s", name + len + 1);
+  else
+    snprintf (variant, sz, "%s", name);
+}
+
+
+/* First environment variable of NAMES set to a positive integer. */
+static
+int polybench_env_int(const char* const* names, int def)
+{
+  for (; *names; names++)
+    if (getenv (*names) != NULL && atoi (getenv (*names)) > 0)
+      return atoi (getenv (*names));
+  return def;
+}
+
+
+static
+void polybench_fprint_string(FILE* f, const char* str, int csv)
+{
+  fputc ('"', f);
+  for (; *str; str++)
+    {
+      if (*str == '"')
+	fputs (csv ? "\"\"" : "\\\"", f);
+      else if (*str == '\\' && ! csv)
+	fputs ("\\\\", f);
+      else if ((unsigned char) *str >= ' ')
+	fputc (*str, f);
+    }
+  fputc ('"', f);
+}
+
+
+static
+void polybench_write_record(char** counter_names,
+			    const long long* counters, int nb_counters)
+{
+  static const char* const rank_vars[] =
+    { "OMPI_COMM_WORLD_SIZE", "PMI_SIZE", "MV2_COMM_WORLD_SIZE", NULL };
+  static const char* const node_vars[] =
+    { "SLURM_JOB_NUM_NODES", "SLURM_NNODES", NULL };
+  const char* path = getenv ("POLYBENCH_RECORD_FILE");
+  char name[256], kernel[256], variant[256], cpu[256], sizes[1024];
+  char cpuset[256];
+  const char* affinity = "none";
+  struct polybench_run_stats st;
+  double* samples = polybench_run_samples + POLYBENCH_WARMUP_RUNS;
+  double flops = polybench_program_total_flops;
+  double bytes = polybench_program_total_bytes;
+  int threads = 1, ranks, nodes, i;
+  const char* cache = "cold";
+  const char* unit = "s";
+  const char* features =
+    polybench_build_features + (polybench_build_features[0] == ' ');
+  FILE* f;
+
+#ifdef _OPENMP
+  threads = omp_get_max_threads ();
+#endif
+#ifdef POLYBENCH_NO_FLUSH_CACHE
+  cache = "hot";
+#endif
+#ifdef POLYBENCH_CYCLE_ACCURATE_TIMER
+  unit = "cycles";
+#endif
+  ranks = polybench_env_int (rank_vars, 1);
+  nodes = polybench_env_int (node_vars, 1);
+  polybench_program_names (name, kernel, variant, sizeof(name));
+  polybench_cpu_model (cpu, sizeof(cpu));
+  polybench_read_topology ();
+  polybench_cpu_set_string (cpuset, sizeof(cpuset));
+#ifdef POLYBENCH_AFFINITY
+  if (polybench_affinity_policy != NULL)
+    affinity = polybench_affinity_policy;
+#endif
+  polybench_run_statistics (&st);
+  sizes[0] = '\0';
+  for (i = 0; i < polybench_nb_sizes; ++i)
+    snprintf (sizes + strlen (sizes), sizeof(sizes) - strlen (sizes),
+	      "%s%s=%d", i ? " " : "", polybench_size_names[i],
+	      polybench_size_values[i]);
+
+  if (path == NULL)
+#ifdef POLYBENCH_RECORD_JSON
+    path = "polybench.jsonl";
+#else
+    path = "polybench.csv";
+#endif
+  if ((f = fopen (path, "a")) == NULL)
+    {
+      fprintf (stderr, "[PolyBench][WARNING] Cannot write records to %s\n",
+	       path);
+      return;
+    }
+
+#ifdef POLYBENCH_RECORD_JSON
+  fprintf (f, "{\"name\":");
+  polybench_fprint_string (f, name, 0);
+  fprintf (f, ",\"kernel\":");
+  polybench_fprint_string (f, kernel, 0);
+  fprintf (f, ",\"variant\":");
+  polybench_fprint_string (f, variant, 0);
+  fprintf (f, ",\"sizes\":{");
+  for (i = 0; i < polybench_nb_sizes; ++i)
+    fprintf (f, "%s\"%s\":%d", i ? "," : "", polybench_size_names[i],
+	     polybench_size_values[i]);
+  fprintf (f, "},\"data_type\":");
+  polybench_fprint_string (f, polybench_program_data_type, 0);
+  fprintf (f, ",\"threads\":%d,\"ranks\":%d,\"nodes\":%d,\"compiler\":",
+	   threads, ranks, nodes);
+  polybench_fprint_string (f, POLYBENCH_COMPILER, 0);
+  fprintf (f, ",\"flags\":");
+  polybench_fprint_string (f, POLYBENCH_CFLAGS, 0);
+  fprintf (f, ",\"features\":");
+  polybench_fprint_string (f, features, 0);
+  fprintf (f, ",\"cpu\":");
+  polybench_fprint_string (f, cpu, 0);
+  fprintf (f, ",\"affinity\":");
+  polybench_fprint_string (f, affinity, 0);
+  fprintf (f, ",\"cpuset\":");
+  polybench_fprint_string (f, cpuset, 0);
+  fprintf (f, ",\"topology\":{\"packages\":%d,\"l3\":%d,\"cores\":%d,"
+	   "\"cpus\":%d},\"thread_cpus\":[", polybench_nb_packages,
+	   polybench_nb_l3, polybench_nb_cores, polybench_nb_cpus);
+  for (i = 0; i < polybench_nb_thread_cpus; ++i)
+    fprintf (f, "%s%d", i ? "," : "", polybench_thread_cpus[i]);
+  fprintf (f, "],\"migrations\":%d", polybench_thread_migrations);
+  if (st.nb > 0)
+    {
+      fprintf (f, ",\"timer\":");
+      polybench_fprint_string (f, polybench_timer_name, 0);
+      fprintf (f, ",\"unit\":\"%s\",\"cache\":\"%s\",\"warmup\":%d,"
+	       "\"samples\":[", unit, cache, POLYBENCH_WARMUP_RUNS);
+      for (i = 0; i < st.nb; ++i)
+	fprintf (f, "%s%0.9g", i ? "," : "", samples[i]);
+      fprintf (f, "],\"runs\":%d,\"min\":%0.9g,\"median\":%0.9g,"
+	       "\"mean\":%0.9g,\"stddev\":%0.9g,\"cv\":%0.4f",
+	       st.nb, st.min, st.median, st.mean, st.stddev, st.cv);
+    }
+  fprintf (f, ",\"flops\":%0.0f,\"bytes\":%0.0f", flops, bytes);
+  if (polybench_layout_nb > 0)
+    fprintf (f, ",\"layout_conversion\":%0.9g",
+	     polybench_layout_time / POLYBENCH_TOTAL_NB_RUNS);
+#ifdef POLYBENCH_MEMORY_REPORT
+  fprintf (f, ",\"memory\":{\"scratch\":%ld,\"high_water\":%ld,"
+	   "\"peak_rss\":%ld}", polybench_memory_scratch_peak,
+	   polybench_memory_high_water, polybench_peak_rss ());
+#endif
+  if (st.nb > 0 && st.median > 0 && ! strcmp (unit, "s"))
+    fprintf (f, ",\"gflops\":%0.6g", flops / st.median / 1e9);
+  fprintf (f, ",\"counters\":{");
+  for (i = 0; i < nb_counters; ++i)
+    {
+      fprintf (f, "%s", i ? "," : "");
+      polybench_fprint_string (f, counter_names[i], 0);
+      fprintf (f, ":%lld", counters[i]);
+    }
+  fprintf (f, "}}\n");
+#else
+  fseek (f, 0, SEEK_END);
+  if (ftell (f) == 0)
+    fprintf (f, "name,runtime,size,n_processors,nodes,kernel,variant,sizes,"
+	     "data_type,threads,ranks,run,warmup,cache,unit,timer,flops,bytes,"
+	     "gflops,compiler,flags,features,cpu,counters,affinity,cpuset,"
+	     "thread_cpus,migrations\n");
+  for (i = 0; i < (st.nb > 0 ? st.nb : 1); ++i)
+    {
+      int k;
+      fprintf (f, "%s,", name);
+      if (st.nb > 0)
+	fprintf (f, "%0.9g", samples[i]);
+      fprintf (f, ",%d,%d,%d,%s,%s,",
+	       polybench_nb_sizes ? polybench_size_values[0] : 0,
+	       threads * ranks, nodes, kernel, variant);
+      polybench_fprint_string (f, sizes, 1);
+      fprintf (f, ",%s,%d,%d,", polybench_program_data_type, threads, ranks);
+      if (st.nb > 0)
+	fprintf (f, "%d,%d,%s,%s,", i, POLYBENCH_WARMUP_RUNS, cache, unit);
+      else
+	fprintf (f, ",,%s,,", cache);
+      polybench_fprint_string (f, st.nb > 0 ? polybench_timer_name : "", 1);
+      fprintf (f, ",%0.0f,%0.0f,", flops, bytes);
+      if (st.nb > 0 && samples[i] > 0 && ! strcmp (unit, "s"))
+	fprintf (f, "%0.6g", flops / samples[i] / 1e9);
+      fprintf (f, ",");
+      polybench_fprint_string (f, POLYBENCH_COMPILER, 1);
+      fprintf (f, ",");
+      polybench_fprint_string (f, POLYBENCH_CFLAGS, 1);
+      fprintf (f, ",");
+      polybench_fprint_string (f, features, 1);
+      fprintf (f, ",");
+      polybench_fprint_string (f, cpu, 1);
+      fprintf (f, ",\"");
+      for (k = 0; k < nb_counters; ++k)
+	fprintf (f, "%s%s=%lld", k ? ";" : "", counter_names[k], counters[k]);
+      fprintf (f, "\",%s,", affinity);
+      polybench_fprint_string (f, cpuset, 1);
+      fprintf (f, ",\"");
+      for (k = 0; k < polybench_nb_thread_cpus; ++k)
+	fprintf (f, "%s%d", k ? " " : "", polybench_thread_cpus[k]);
+      fprintf (f, "\",%d\n", polybench_thread_migrations);
+    }
+#endif
+  fclose (f);
+}
+#endif
+/* ! POLYBENCH_RECORD */
+
+
+void polybench_timer_print()
+{
+  double elapsed;
+  int verbose = polybench_nb_samples > 1;
+#ifdef POLYBENCH_TIMER_VERBOSE
+  verbose = 1;
+#endif
+  if (verbose)
+    polybench_timer_print_info ();
+#if POLYBENCH_NB_RUNS + POLYBENCH_WARMUP_RUNS > 1
+  if (polybench_nb_samples > 1)
+    elapsed = polybench_print_run_statistics ();
+  else
+#endif
+#ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
+    elapsed = polybench_t_end - polybench_t_start;
+#else
+    elapsed = (double)(polybench_c_end - polybench_c_start);
+#endif
+#if !defined(POLYBENCH_GFLOPS) && !defined(POLYBENCH_ROOFLINE)
+  if (verbose)
+#endif
+    polybench_print_program_model (elapsed);
+  polybench_print_reports ();
+#ifdef POLYBENCH_RECORD
+  polybench_write_record (NULL, NULL, 0);
+#endif
+#ifdef POLYBENCH_GFLOPS
+      if  (polybench_program_total_flops == 0)
+	{
+	  printf ("[PolyBench][WARNING] Program flops not defined, use polybench_set_program_flops(value)\n");
+	  printf ("%0.6lf\n", elapsed);
+	}
+      else
+	printf ("%0.2lf\n",
+		(polybench_program_total_flops / elapsed) / 1000000000);
+#else
+# ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
+      printf ("%0.6f\n", elapsed);
+# else
+      printf ("%Ld\n", (long long int) elapsed);
+# endif
+#endif
+}
+
+/* Pages backing an array allocated with polybench_alloc_data. */
+#define POLYBENCH_PAGES_DEFAULT 0
+#define POLYBENCH_PAGES_THP 1
+#define POLYBENCH_PAGES_HUGETLB_2M 2
+#define POLYBENCH_PAGES_HUGETLB_1G 3
+
+#ifdef POLYBENCH_HUGEPAGES
+/*
+ * Huge page allocation. -DPOLYBENCH_HUGEPAGES=thp backs the arrays of
+ * at least POLYBENCH_HUGEPAGES_MIN_KB with transparent huge pages
+ * (2MB-aligned, madvise(MADV_HUGEPAGE)); =2M or =1G maps them from the
+ * hugetlbfs pool of that page size (MAP_HUGETLB), rounding their size
+ * up to a whole number of pages. When the pool is empty, the
+ * allocation falls back to transparent huge pages, and then to normal
+ * pages. The page size actually received by each array is reported on
+ * stderr when it is freed, i.e. after the kernel has touched it.
+ */
+# ifndef POLYBENCH_HUGEPAGES_MIN_KB
+#  define POLYBENCH_HUGEPAGES_MIN_KB 2048
+# endif
+# ifndef MAP_HUGE_SHIFT
+#  define MAP_HUGE_SHIFT 26
+# endif
+# define POLYBENCH_THP_SIZE (2UL * 1024 * 1024)
+
+static
+size_t polybench_hugetlb_page_size(int page_kind)
+{
+  return page_kind == POLYBENCH_PAGES_HUGETLB_1G ?
+    1024UL * 1024 * 1024 : POLYBENCH_THP_SIZE;
+}
+
+static
+void* polybench_alloc_pages(size_t sz, int* page_kind)
+{
+  static int warned = 0;
+  const char* mode = POLYBENCH_STRINGIFY(POLYBENCH_HUGEPAGES);
+  void* ret = NULL;
+
+  *page_kind = POLYBENCH_PAGES_DEFAULT;
+  if (sz < (size_t) POLYBENCH_HUGEPAGES_MIN_KB * 1024)
+    return NULL;
+# ifdef MAP_HUGETLB
+  if (! strcmp (mode, "2M") || ! strcmp (mode, "1G"))
+    {
+      int kind = mode[1] == 'G' ?
+	POLYBENCH_PAGES_HUGETLB_1G : POLYBENCH_PAGES_HUGETLB_2M;
+      size_t page = polybench_hugetlb_page_size (kind);
+      int shift = kind == POLYBENCH_PAGES_HUGETLB_1G ? 30 : 21;
+      ret = mmap (NULL, (sz + page - 1) / page * page,
+		  PROT_READ | PROT_WRITE,
+		  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB
+		  | (shift << MAP_HUGE_SHIFT), -1, 0);
+      if (ret != MAP_FAILED)
+	{
+	  *page_kind = kind;
+	  return ret;
+	}
+      if (! warned++)
+	fprintf (stderr, "[PolyBench][WARNING] Cannot map %s huge pages"
+		 " (see /proc/sys/vm/nr_hugepages), using transparent huge"
+		 " pages\n", mode);
+    }
+  else
+# endif
+  if (strcmp (mode, "thp") && ! warned++)
+    fprintf (stderr, "[PolyBench][WARNING] Unknown huge page mode %s,"
+	     " using transparent huge pages\n", mode);
+# ifdef MADV_HUGEPAGE
+  ret = NULL;
+  if (posix_memalign (&ret, POLYBENCH_THP_SIZE, sz) == 0 && ret != NULL)
+    {
+      if (madvise (ret, sz, MADV_HUGEPAGE) == 0)
+	*page_kind = POLYBENCH_PAGES_THP;
+      return ret;
+    }
+# endif
+  return NULL;
+}
+
+
+static
+void polybench_free_pages(void* ptr, size_t sz, int page_kind)
+{
+  if (page_kind == POLYBENCH_PAGES_HUGETLB_2M
+      || page_kind == POLYBENCH_PAGES_HUGETLB_1G)
+    {
+      size_t page = polybench_hugetlb_page_size (page_kind);
+      munmap (ptr, (sz + page - 1) / page * page);
+    }
+  else
+    free (ptr);
+}
+
+
+/* Report the pages backing the array ID of the allocation table, if it
+   is large enough for huge pages, from the mapping which contains it in
+   /proc/self/smaps. */
+static
+void polybench_report_page_size(int id)
+{
+  static const char* kinds[] = { "default", "thp", "hugetlb 2M", "hugetlb 1G" };
+  unsigned long addr = (unsigned long) _polybench_alloc_table->real_ptr[id];
+  unsigned long start, end, val;
+  unsigned long rss = 0, anon_huge = 0, page_kb = 0;
+  int in_vma = 0;
+  char line[1024];
+  FILE* f;
+
+  if (_polybench_alloc_table->size[id] < (size_t) POLYBENCH_HUGEPAGES_MIN_KB * 1024
+      || (f = fopen ("/proc/self/smaps", "r")) == NULL)
+    return;
+  while (fgets (line, sizeof(line), f) != NULL)
+    {
+      if (sscanf (line, "%lx-%lx ", &start, &end) == 2)
+	{
+	  if (in_vma)
+	    break;
+	  in_vma = start <= addr && addr < end;
+	}
+      else if (in_vma && sscanf (line, "Rss: %lu", &val) == 1)
+	rss = val;
+      else if (in_vma && sscanf (line, "AnonHugePages: %lu", &val) == 1)
+	anon_huge = val;
+      else if (in_vma && sscanf (line, "KernelPageSize: %lu", &val) == 1)
+	page_kb = val;
+    }
+  fclose (f);
+  fprintf (stderr, "[PolyBench] array %p (%0.1f MB): requested %s,"
+	   " page size %lu kB", _polybench_alloc_table->user_view[id],
+	   _polybench_alloc_table->size[id] / (1024.0 * 1024),
+	   kinds[_polybench_alloc_table->page_kind[id]], page_kb);
+  if (page_kb < POLYBENCH_THP_SIZE / 1024 && rss > 0)
+    fprintf (stderr, ", %0.1f%% in transparent huge pages",
+	     100.0 * anon_huge / rss);
+  fprintf (stderr, "\n");
+}
+#endif
+
+
+#ifdef POLYBENCH_NUMA
+/*
+ * NUMA placement of the arrays allocated with polybench_alloc_data,
+ * with -DPOLYBENCH_NUMA=firsttouch (the default policy of the system,
+ * with the initialization distributed by polybench_parallel_init),
+ * interleave (pages spread round-robin over all the online nodes), or
+ * bind (pages on node POLYBENCH_NUMA_NODE). The policy is set with the
+ * mbind system call, so that no library is required, before the pages
+ * are touched.
+ */
+# ifndef POLYBENCH_NUMA_NODE
+#  define POLYBENCH_NUMA_NODE 0
+# endif
+# define POLYBENCH_MAX_NUMA_NODES 1024
+# define POLYBENCH_MPOL_BIND 2
+# define POLYBENCH_MPOL_INTERLEAVE 3
+
+/* Parse a node list such as "0-3,8" into a bitmask. */
+static
+int polybench_parse_node_list(const char* list, unsigned long* mask)
+{
+  int first, last, n = 0, nb = 0;
+  const int bits = 8 * sizeof(unsigned long);
+
+  while (sscanf (list, "%d%n", &first, &n) == 1)
+    {
+      list += n;
+      last = first;
+      if (*list == '-' && sscanf (list + 1, "%d%n", &last, &n) == 1)
+	list += n + 1;
+      for (; first <= last && first < POLYBENCH_MAX_NUMA_NODES; first++, nb++)
+	mask[first / bits] |= 1UL << (first % bits);
+      if (*list != ',')
+	break;
+      list++;
+    }
+  return nb;
+}
+
+
+static
+void polybench_numa_place(void* ptr, size_t sz)
+{
+  static int warned = 0;
+  const char* mode = POLYBENCH_STRINGIFY(POLYBENCH_NUMA);
+  unsigned long mask[POLYBENCH_MAX_NUMA_NODES / (8 * sizeof(unsigned long))];
+  char buf[1024];
+  int policy;
+  FILE* f;
+
+  memset (mask, 0, sizeof(mask));
+  if (! strcmp (mode, "firsttouch"))
+    return;
+  if (! strcmp (mode, "interleave"))
+    {
+      policy = POLYBENCH_MPOL_INTERLEAVE;
+      buf[0] = '\0';
+      if ((f = fopen ("/sys/devices/system/node/online", "r")) != NULL)
+	{
+	  if (fgets (buf, sizeof(buf), f) == NULL)
+	    buf[0] = '\0';
+	  fclose (f);
+	}
+      if (polybench_parse_node_list (buf, mask) == 0)
+	mask[0] = 1;
+    }
+  else if (! strcmp (mode, "bind"))
+    {
+      policy = POLYBENCH_MPOL_BIND;
+      snprintf (buf, sizeof(buf), "%d", POLYBENCH_NUMA_NODE);
+      polybench_parse_node_list (buf, mask);
+    }
+  else
+    {
+      if (! warned++)
+	fprintf (stderr, "[PolyBench][WARNING] Unknown NUMA policy %s,"
+		 " using first touch\n", mode);
+      return;
+    }
+  if (syscall (SYS_mbind, ptr, sz, policy, mask,
+	       (unsigned long) POLYBENCH_MAX_NUMA_NODES + 1, 0) != 0
+      && ! warned++)
+    fprintf (stderr, "[PolyBench][WARNING] mbind: cannot apply the %s"
+	     " NUMA policy\n", mode);
+}
+
+
+/* Report, on stderr, the number of pages of each array on each node,
+   from the mapping which contains it in /proc/self/numa_maps. Small
+   arrays may share a mapping, whose total is then reported for each. */
+static
+void polybench_print_numa_placement()
+{
+  char line[4096], best[4096];
+  int i;
+
+  for (i = 0; _polybench_alloc_table != NULL
+	 && i < _polybench_alloc_table->nb_entries; ++i)
+    {
+      unsigned long addr = (unsigned long) _polybench_alloc_table->real_ptr[i];
+      unsigned long start, best_start = 0;
+      char* tok;
+      FILE* f = fopen ("/proc/self/numa_maps", "r");
+
+      if (f == NULL)
+	return;
+      best[0] = '\0';
+      while (fgets (line, sizeof(line), f) != NULL)
+	if (sscanf (line, "%lx", &start) == 1
+	    && start <= addr && start >= best_start)
+	  {
+	    best_start = start;
+	    strcpy (best, line);
+	  }
+      fclose (f);
+      fprintf (stderr, "[PolyBench] array %p (%0.1f MB): mapping=%lx",
+	       _polybench_alloc_table->user_view[i],
+	       _polybench_alloc_table->size[i] / (1024.0 * 1024), best_start);
+      /* Policy, then the page counts per node (N<node>=<pages>). */
+      for (tok = strtok (best, " \n"); tok != NULL; tok = strtok (NULL, " \n"))
+	if (tok[0] == 'N' && strchr (tok, '='))
+	  fprintf (stderr, " %s", tok);
+	else if (strchr (tok, ':') || ! strcmp (tok, "default"))
+	  fprintf (stderr, " policy=%s", tok);
+      fprintf (stderr, "\n");
+    }
+}
+#endif
+
+
+#ifdef POLYBENCH_MEMORY_REPORT
+/*
+ * Memory footprint, with -DPOLYBENCH_MEMORY_REPORT: the bytes held by
+ * the arrays allocated with polybench_alloc_data (including padding)
+ * and by the scratch arenas of all the threads, their high-water mark,
+ * and the peak resident set size of the process.
+ */
+static long polybench_memory_arrays = 0;
+static long polybench_memory_scratch = 0;
+static long polybench_memory_scratch_peak = 0;
+static long polybench_memory_high_water = 0;
+
+static
+void polybench_account_memory(long arrays, long scratch)
+{
+#ifdef _OPENMP
+#pragma omp critical (polybench_memory)
+#endif
+  {
+    polybench_memory_arrays += arrays;
+    polybench_memory_scratch += scratch;
+    if (polybench_memory_scratch > polybench_memory_scratch_peak)
+      polybench_memory_scratch_peak = polybench_memory_scratch;
+    if (polybench_memory_arrays + polybench_memory_scratch
+	> polybench_memory_high_water)
+      polybench_memory_high_water =
+	polybench_memory_arrays + polybench_memory_scratch;
+  }
+}
+
+
+/* Peak resident set size of the process, in bytes. */
+static
+long polybench_peak_rss()
+{
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) != 0)
+    return 0;
+  return usage.ru_maxrss * 1024L;
+}
+
+
+void polybench_name_data(void* ptr, const char* name)
+{
+  int i;
+
+  for (i = 0; _polybench_alloc_table != NULL
+	 && i < _polybench_alloc_table->nb_entries; ++i)
+    if (_polybench_alloc_table->user_view[i] == ptr)
+      _polybench_alloc_table->name[i] = name;
+}
+
+
+/* Report, on stderr, the bytes of each live array, then the totals. */
+static
+void polybench_print_memory()
+{
+  const double mb = 1024.0 * 1024;
+  int i;
+
+  for (i = 0; _polybench_alloc_table != NULL
+	 && i < _polybench_alloc_table->nb_entries; ++i)
+    {
+      fprintf (stderr, "[PolyBench] memory: array ");
+      if (_polybench_alloc_table->name[i] != NULL)
+	fprintf (stderr, "%s", _polybench_alloc_table->name[i]);
+      else
+	fprintf (stderr, "%p", _polybench_alloc_table->user_view[i]);
+      fprintf (stderr, " %lu bytes (%0.2f MB), aligned on %lu\n",
+	       (unsigned long) _polybench_alloc_table->size[i],
+	       _polybench_alloc_table->size[i] / mb,
+	       (unsigned long) _polybench_alloc_table->alignment[i]);
+    }
+  fprintf (stderr, "[PolyBench] memory: arrays %0.2f MB, scratch %0.2f MB,"
+	   " high-water %0.2f MB, flush buffer %0.2f MB, peak RSS %0.2f MB\n",
+	   polybench_memory_arrays / mb, polybench_memory_scratch_peak / mb,
+	   polybench_memory_high_water / mb,
+	   polybench_flush_buffer_size * sizeof(double) / mb,
+	   polybench_peak_rss () / mb);
+}
+#endif
+
+
+/*
+ * These functions are used only if the user defines a specific
+ * inter-array padding, POLYBENCH_FLUSH_CLFLUSHOPT, POLYBENCH_HUGEPAGES,
+ * POLYBENCH_NUMA or POLYBENCH_MEMORY_REPORT. It grows a global structure,
+ * _polybench_alloc_table, which keeps track of the data allocated via
+ * polybench_alloc_data (on which inter-array padding is applied), so
+ * that the original, non-shifted pointer can be recovered when
+ * calling polybench_free_data.
+ *
+ */
+#ifdef POLYBENCH_ALLOC_TABLE
+static
+void grow_alloc_table()
+{
+  if (_polybench_alloc_table == NULL ||
+      (_polybench_alloc_table->nb_entries % NB_INITIAL_TABLE_ENTRIES) != 0 ||
+      _polybench_alloc_table->nb_avail_entries != 0)
+    {
+      /* Should never happen if the API is properly used. */
+      fprintf (stderr, "[ERROR] Inter-array padding requires to use polybench_alloc_data and polybench_free_data\n");
+      exit (1);
+    }
+  size_t sz = _polybench_alloc_table->nb_entries;
+  sz += NB_INITIAL_TABLE_ENTRIES;
+  _polybench_alloc_table->user_view =
+    realloc (_polybench_alloc_table->user_view, sz * sizeof(void*));
+  assert(_polybench_alloc_table->user_view != NULL);
+  _polybench_alloc_table->real_ptr =
+    realloc (_polybench_alloc_table->real_ptr, sz * sizeof(void*));
+  assert(_polybench_alloc_table->real_ptr != NULL);
+  _polybench_alloc_table->size =
+    realloc (_polybench_alloc_table->size, sz * sizeof(size_t));
+  assert(_polybench_alloc_table->size != NULL);
+  _polybench_alloc_table->alignment =
+    realloc (_polybench_alloc_table->alignment, sz * sizeof(size_t));
+  assert(_polybench_alloc_table->alignment != NULL);
+  _polybench_alloc_table->name =
+    realloc (_polybench_alloc_table->name, sz * sizeof(const char*));
+  assert(_polybench_alloc_table->name != NULL);
+  _polybench_alloc_table->page_kind =
+    realloc (_polybench_alloc_table->page_kind, sz * sizeof(int));
+  assert(_polybench_alloc_table->page_kind != NULL);
+  _polybench_alloc_table->nb_avail_entries = NB_INITIAL_TABLE_ENTRIES;
+}
+
+static
+void* register_padded_pointer(void* ptr, size_t orig_sz, size_t padded_sz,
+			      int page_kind)
+{
+  if (_polybench_alloc_table == NULL)
+    {
+      fprintf (stderr, "[ERROR] Inter-array padding requires to use polybench_alloc_data and polybench_free_data\n");
+      exit (1);
+    }
+  if (_polybench_alloc_table->nb_avail_entries == 0)
+    grow_alloc_table ();
+  int id = _polybench_alloc_table->nb_entries++;
+  _polybench_alloc_table->real_ptr[id] = ptr;
+  _polybench_alloc_table->size[id] = padded_sz;
+  _polybench_alloc_table->page_kind[id] = page_kind;
+#ifdef POLYBENCH_ENABLE_INTARRAY_PAD
+  _polybench_alloc_table->user_view[id] = ptr + (padded_sz - orig_sz);
+#else
+  _polybench_alloc_table->user_view[id] = ptr;
+#endif
+  /* Largest power of two, up to a page, dividing the user address. */
+  _polybench_alloc_table->alignment[id] = 4096;
+  while ((unsigned long) _polybench_alloc_table->user_view[id]
+	 % _polybench_alloc_table->alignment[id] != 0)
+    _polybench_alloc_table->alignment[id] /= 2;
+  _polybench_alloc_table->name[id] = NULL;
+#ifdef POLYBENCH_MEMORY_REPORT
+  polybench_account_memory (padded_sz, 0);
+#endif
+
+  return _polybench_alloc_table->user_view[id];
+}
+
+
+static
+void
+free_data_from_alloc_table (void* ptr)
+{
+  if (_polybench_alloc_table != NULL && _polybench_alloc_table->nb_entries > 0)
+    {
+      int i;
+      for (i = 0; i < _polybench_alloc_table->nb_entries; ++i)
+	if (_polybench_alloc_table->user_view[i] == ptr ||
+	    _polybench_alloc_table->real_ptr[i] == ptr)
+	  break;
+      if (i != _polybench_alloc_table->nb_entries)
+	{
+#ifdef POLYBENCH_HUGEPAGES
+	  polybench_report_page_size (i);
+	  polybench_free_pages (_polybench_alloc_table->real_ptr[i],
+				_polybench_alloc_table->size[i],
+				_polybench_alloc_table->page_kind[i]);
+#else
+	  free (_polybench_alloc_table->real_ptr[i]);
+#endif
+#ifdef POLYBENCH_MEMORY_REPORT
+	  polybench_account_memory (- (long) _polybench_alloc_table->size[i], 0);
+#endif
+	  for (; i < _polybench_alloc_table->nb_entries - 1; ++i)
+	    {
+	      _polybench_alloc_table->user_view[i] =
+		_polybench_alloc_table->user_view[i + 1];
+	      _polybench_alloc_table->real_ptr[i] =
+		_polybench_alloc_table->real_ptr[i + 1];
+	      _polybench_alloc_table->size[i] =
+		_polybench_alloc_table->size[i + 1];
+	      _polybench_alloc_table->alignment[i] =
+		_polybench_alloc_table->alignment[i + 1];
+	      _polybench_alloc_table->name[i] =
+		_polybench_alloc_table->name[i + 1];
+	      _polybench_alloc_table->page_kind[i] =
+		_polybench_alloc_table->page_kind[i + 1];
+	    }
+	  _polybench_alloc_table->nb_entries--;
+	  _polybench_alloc_table->nb_avail_entries++;
+	  if (_polybench_alloc_table->nb_entries == 0)
+	    {
+	      free (_polybench_alloc_table->user_view);
+	      free (_polybench_alloc_table->real_ptr);
+	      free (_polybench_alloc_table->size);
+	      free (_polybench_alloc_table->alignment);
+	      free (_polybench_alloc_table->name);
+	      free (_polybench_alloc_table->page_kind);
+	      free (_polybench_alloc_table);
+	      _polybench_alloc_table = NULL;
+	    }
+	  return;
+	}
+    }
+  /* Not allocated by polybench_alloc_data. */
+  free (ptr);
+}
+
+static
+void check_alloc_table_state()
+{
+  if (_polybench_alloc_table == NULL)
+    {
+      _polybench_alloc_table = (struct polybench_data_ptrs*)
+	malloc (sizeof(struct polybench_data_ptrs));
+      assert(_polybench_alloc_table != NULL);
+      _polybench_alloc_table->user_view =
+	(void**) malloc (sizeof(void*) * NB_INITIAL_TABLE_ENTRIES);
+      assert(_polybench_alloc_table->user_view != NULL);
+      _polybench_alloc_table->real_ptr =
+	(void**) malloc (sizeof(void*) * NB_INITIAL_TABLE_ENTRIES);
+      assert(_polybench_alloc_table->real_ptr != NULL);
+      _polybench_alloc_table->size =
+	(size_t*) malloc (sizeof(size_t) * NB_INITIAL_TABLE_ENTRIES);
+      assert(_polybench_alloc_table->size != NULL);
+      _polybench_alloc_table->alignment =
+	(size_t*) malloc (sizeof(size_t) * NB_INITIAL_TABLE_ENTRIES);
+      assert(_polybench_alloc_table->alignment != NULL);
+      _polybench_alloc_table->name =
+	(const char**) malloc (sizeof(const char*) * NB_INITIAL_TABLE_ENTRIES);
+      assert(_polybench_alloc_table->name != NULL);
+      _polybench_alloc_table->page_kind =
+	(int*) malloc (sizeof(int) * NB_INITIAL_TABLE_ENTRIES);
+      assert(_polybench_alloc_table->page_kind != NULL);
+      _polybench_alloc_table->nb_entries = 0;
+      _polybench_alloc_table->nb_avail_entries = NB_INITIAL_TABLE_ENTRIES;
+    }
+}
+
+#endif // !POLYBENCH_ALLOC_TABLE
+
+
+static
+void*
+xmalloc(size_t alloc_sz)
+{
+  void* ret = NULL;
+  /* By default, post-pad the arrays. Safe behavior, but likely useless. */
+  polybench_inter_array_padding_sz += POLYBENCH_INTER_ARRAY_PADDING_FACTOR;
+  size_t offset = polybench_inter_array_padding_sz;
+#ifdef POLYBENCH_AUTO_PADDING
+  offset += polybench_auto_array_offset ();
+#endif
+  /* Keep the user view of the array aligned on POLYBENCH_ALIGNMENT. */
+  offset = (offset + POLYBENCH_ALIGNMENT - 1)
+    / POLYBENCH_ALIGNMENT * POLYBENCH_ALIGNMENT;
+  size_t padded_sz = alloc_sz + offset;
+#ifdef POLYBENCH_ALLOC_TABLE
+  int page_kind = POLYBENCH_PAGES_DEFAULT;
+#endif
+#ifdef POLYBENCH_HUGEPAGES
+  ret = polybench_alloc_pages (padded_sz, &page_kind);
+#endif
+  if (! ret)
+    {
+      int err = posix_memalign (&ret, POLYBENCH_ALIGNMENT > 4096 ?
+				POLYBENCH_ALIGNMENT : 4096, padded_sz);
+      if (! ret || err)
+	{
+	  fprintf (stderr, "[PolyBench] posix_memalign: cannot allocate memory");
+	  exit (1);
+	}
+    }
+#ifdef POLYBENCH_NUMA
+  polybench_numa_place (ret, padded_sz);
+#endif
+  /* Safeguard: this is invoked only if polybench.c has been compiled
+     with inter-array padding support from polybench.h. If so, move
+     the starting address of the allocation and return it to the
+     user. The original pointer is registered in an allocation table
+     internal to polybench.c. Data must then be freed using
+     polybench_free_data, which will inspect the allocation table to
+     free the original pointer.*/
+#ifdef POLYBENCH_ALLOC_TABLE
+  /* This moves the 'ret' pointer by (padded_sz - alloc_sz) positions, and
+  registers it in the lookup table for future free using
+  polybench_free_data. */
+  ret = register_padded_pointer(ret, alloc_sz, padded_sz, page_kind);
+#endif
+
+  return ret;
+}
+
+
+void polybench_free_data(void* ptr)
+{
+#ifdef POLYBENCH_ALLOC_TABLE
+  free_data_from_alloc_table (ptr);
+#else
+  free (ptr);
+#endif
+}
+
+
+void* polybench_alloc_data(unsigned long long int n, int elt_size)
+{
+#ifdef POLYBENCH_AFFINITY
+  polybench_affinity_apply ();
+#endif
+#ifdef POLYBENCH_ALLOC_TABLE
+  check_alloc_table_state ();
+#endif
+
+  /// FIXME: detect overflow!
+  size_t val = n;
+  val *= elt_size;
+  void* ret = xmalloc (val);
+
+  return ret;
+}
+
+
+/*
+ * Scratch arena for the temporaries of the kernels. Each thread has its
+ * own arena: a single aligned block, from which polybench_scratch_alloc
+ * bumps a position, so that the kernels get their temporaries without
+ * calling malloc, faulting new pages or growing the stack. Everything
+ * allocated after polybench_scratch_mark is released at once by
+ * polybench_scratch_release, at the end of a phase or of a level of a
+ * recursion. A request which does not fit in the block is served by
+ * malloc until the arena is next emptied, when the block is grown to
+ * the peak usage, so that only the first run pays for it.
+ */
+struct polybench_scratch
+{
+  char* block;
+  size_t size;
+  size_t pos;
+  size_t peak;
+  /* Allocations beyond the block, with their position and size. */
+  void** overflow;
+  size_t* overflow_pos;
+  size_t* overflow_size;
+  int nb_overflow;
+  int max_overflow;
+};
+
+static __thread struct polybench_scratch polybench_scratch_arena;
+
+
+/* Replace the block of the calling thread by a block of SIZE bytes,
+   touched by the thread itself, hence on its NUMA node. */
+static
+void polybench_scratch_grow(size_t size)
+{
+  struct polybench_scratch* a = &polybench_scratch_arena;
+  void* block = NULL;
+
+  size = (size + 4095) / 4096 * 4096;
+  if (posix_memalign (&block, POLYBENCH_ALIGNMENT > 4096 ?
+		      POLYBENCH_ALIGNMENT : 4096, size) || block == NULL)
+    {
+      fprintf (stderr, "[PolyBench] posix_memalign: cannot allocate memory");
+      exit (1);
+    }
+  memset (block, 0, size);
+#ifdef POLYBENCH_MEMORY_REPORT
+  polybench_account_memory (0, (long) size - (long) a->size);
+#endif
+  free (a->block);
+  a->block = block;
+  a->size = size;
+}
+
+
+void polybench_scratch_reserve(unsigned long size)
+{
+  struct polybench_scratch* a = &polybench_scratch_arena;
+
+  if (a->pos != 0)
+    {
+      fprintf (stderr, "[PolyBench] polybench_scratch_reserve: the scratch"
+	       " arena is in use\n");
+      exit (1);
+    }
+  if (a->size < size)
+    polybench_scratch_grow (size);
+}
+
+
+void* polybench_scratch_alloc(unsigned long size)
+{
+  struct polybench_scratch* a = &polybench_scratch_arena;
+  size_t pos = a->pos;
+  void* ret;
+
+  size = (size + POLYBENCH_ALIGNMENT - 1)
+    / POLYBENCH_ALIGNMENT * POLYBENCH_ALIGNMENT;
+  if (pos == 0 && a->size < size)
+    polybench_scratch_grow (size > a->peak ? size : a->peak);
+  a->pos += size;
+  if (a->pos > a->peak)
+    a->peak = a->pos;
+  if (a->pos <= a->size)
+    return a->block + pos;
+
+  if (a->nb_overflow == a->max_overflow)
+    {
+      a->max_overflow = a->max_overflow ? 2 * a->max_overflow : 16;
+      a->overflow = realloc (a->overflow, a->max_overflow * sizeof(void*));
+      a->overflow_pos = realloc (a->overflow_pos,
+				 a->max_overflow * sizeof(size_t));
+      a->overflow_size = realloc (a->overflow_size,
+				  a->max_overflow * sizeof(size_t));
+      assert(a->overflow != NULL && a->overflow_pos != NULL
+	     && a->overflow_size != NULL);
+    }
+  ret = NULL;
+  if (posix_memalign (&ret, POLYBENCH_ALIGNMENT, size) || ret == NULL)
+    {
+      fprintf (stderr, "[PolyBench] posix_memalign: cannot allocate memory");
+      exit (1);
+    }
+#ifdef POLYBENCH_MEMORY_REPORT
+  polybench_account_memory (0, size);
+#endif
+  a->overflow[a->nb_overflow] = ret;
+  a->overflow_size[a->nb_overflow] = size;
+  a->overflow_pos[a->nb_overflow++] = pos;
+
+  return ret;
+}
+
+
+unsigned long polybench_scratch_mark()
+{
+  return polybench_scratch_arena.pos;
+}
+
+
+void polybench_scratch_release(unsigned long mark)
+{
+  struct polybench_scratch* a = &polybench_scratch_arena;
+
+  while (a->nb_overflow > 0 && a->overflow_pos[a->nb_overflow - 1] >= mark)
+    {
+      a->nb_overflow--;
+#ifdef POLYBENCH_MEMORY_REPORT
+      polybench_account_memory (0, - (long) a->overflow_size[a->nb_overflow]);
+#endif
+      free (a->overflow[a->nb_overflow]);
+    }
+  if (mark < a->pos)
+    a->pos = mark;
+  if (a->pos == 0 && a->size < a->peak)
+    polybench_scratch_grow (a->peak);
+}
+
+
+void polybench_scratch_free()
+{
+  struct polybench_scratch* a = &polybench_scratch_arena;
+
+  while (a->nb_overflow > 0)
+    {
+      a->nb_overflow--;
+#ifdef POLYBENCH_MEMORY_REPORT
+      polybench_account_memory (0, - (long) a->overflow_size[a->nb_overflow]);
+#endif
+      free (a->overflow[a->nb_overflow]);
+    }
+#ifdef POLYBENCH_MEMORY_REPORT
+  polybench_account_memory (0, - (long) a->size);
+#endif
+  free (a->block);
+  free (a->overflow);
+  free (a->overflow_pos);
+  free (a->overflow_size);
+  memset (a, 0, sizeof(*a));
+}
+
+
+#ifdef POLYBENCH_DATASET_CACHE
+/*
+ * Dataset cache. The arrays and scalars registered by the program are
+ * written, once initialized, to
+ * $POLYBENCH_DATASET_DIR/<program>.<data type>.<sizes>.dataset
+ * [default directory: the current one], e.g.
+ * ludcmp-blocking-openmp-fma.double.N2048.dataset. The key includes
+ * the variant, as the variants do not all initialize their data alike.
+ * The file starts with a header of one page, holding the data type,
+ * the sizes, the size of each entry (which accounts for the padding
+ * of the arrays) and a checksum of the data, followed by the entries
+ * aligned on POLYBENCH_DATASET_ALIGNMENT. Later executions map the
+ * file and copy the entries into the arrays if the header matches the
+ * program and the checksum the data; otherwise, the data are
+ * initialized and the file rewritten. With POLYBENCH_DATASET_POPULATE,
+ * the mapping is populated at once, on transparent huge pages where
+ * the file system supports them (e.g. a tmpfs mounted with huge=).
+ * POLYBENCH_DATASET_CACHE=off in the environment disables the cache.
+ */
+# include <stdarg.h>
+# include <fcntl.h>
+# include <sys/stat.h>
+# define POLYBENCH_DATASET_MAGIC "PBDATA1"
+# define POLYBENCH_DATASET_MAX_ENTRIES 32
+# define POLYBENCH_DATASET_MAX_SIZES 16
+# define POLYBENCH_DATASET_HEADER_SIZE 4096
+# define POLYBENCH_DATASET_ALIGNMENT 64
+
+struct polybench_dataset_header
+{
+  char magic[8];
+  char data_type[16];
+  int nb_sizes;
+  int sizes[POLYBENCH_DATASET_MAX_SIZES];
+  int nb_entries;
+  unsigned long long entry_size[POLYBENCH_DATASET_MAX_ENTRIES];
+  unsigned long long checksum;
+};
+
+static const char* polybench_dataset_name[POLYBENCH_DATASET_MAX_ENTRIES];
+static void* polybench_dataset_ptr[POLYBENCH_DATASET_MAX_ENTRIES];
+static struct polybench_dataset_header polybench_dataset_key;
+static char polybench_dataset_path[4096];
+static int polybench_dataset_enabled = -1;
+/* Mapping of the file, kept for the repetitions. */
+static char* polybench_dataset_map = NULL;
+static size_t polybench_dataset_map_size = 0;
+
+
+void polybench_dataset_add(const char* name, void* ptr, unsigned long size)
+{
+  int i = polybench_dataset_key.nb_entries;
+
+  if (i >= POLYBENCH_DATASET_MAX_ENTRIES)
+    {
+      fprintf (stderr, "[PolyBench] dataset cache: too many entries, %s ignored\n",
+	       name);
+      return;
+    }
+  polybench_dataset_name[i] = name;
+  polybench_dataset_ptr[i] = ptr;
+  polybench_dataset_key.entry_size[i] = size;
+  polybench_dataset_key.nb_entries++;
+}
+
+
+static
+size_t polybench_dataset_offset(int entry)
+{
+  size_t offset = POLYBENCH_DATASET_HEADER_SIZE;
+  int i;
+
+  for (i = 0; i < entry; i++)
+    offset += (polybench_dataset_key.entry_size[i]
+	       + POLYBENCH_DATASET_ALIGNMENT - 1)
+      / POLYBENCH_DATASET_ALIGNMENT * POLYBENCH_DATASET_ALIGNMENT;
+  return offset;
+}
+
+
+/* FNV-1a, 8 bytes at a time. */
+static
+unsigned long long polybench_dataset_hash(const void* data, size_t size,
+					  unsigned long long h)
+{
+  const unsigned char* p = (const unsigned char*) data;
+  unsigned long long w;
+  size_t i;
+
+  for (i = 0; i + sizeof(w) <= size; i += sizeof(w))
+    {
+      memcpy (&w, p + i, sizeof(w));
+      h = (h ^ w) * 0x100000001b3ULL;
+    }
+  for (; i < size; i++)
+    h = (h ^ p[i]) * 0x100000001b3ULL;
+  return h;
+}
+
+
+static
+unsigned long long polybench_dataset_checksum(char* const* entries)
+{
+  unsigned long long h = 0xcbf29ce484222325ULL;
+  int i;
+
+  for (i = 0; i < polybench_dataset_key.nb_entries; i++)
+    h = polybench_dataset_hash (entries[i],
+				polybench_dataset_key.entry_size[i], h);
+  return h;
+}
+
+
+/* Build the key and the path of the cache file, once. */
+static
+void polybench_dataset_init(const char* file, const char* data_type,
+			    va_list ap)
+{
+  struct polybench_dataset_header* key = &polybench_dataset_key;
+  const char* env = getenv ("POLYBENCH_DATASET_CACHE");
+  const char* dir = getenv ("POLYBENCH_DATASET_DIR");
+  const char* base = strrchr (file, '/');
+  const char* name;
+  size_t len;
+
+  polybench_dataset_enabled =
+    ! (env != NULL && (! strcmp (env, "off") || ! strcmp (env, "0")));
+  memcpy (key->magic, POLYBENCH_DATASET_MAGIC, sizeof(key->magic));
+  snprintf (key->data_type, sizeof(key->data_type), "%s", data_type);
+  base = base ? base + 1 : file;
+  len = strrchr (base, '.') ? (size_t) (strrchr (base, '.') - base)
+    : strlen (base);
+  snprintf (polybench_dataset_path, sizeof(polybench_dataset_path),
+	    "%s/%.*s.%s", dir && *dir ? dir : ".", (int) len, base, data_type);
+  while ((name = va_arg (ap, const char*)) != NULL
+	 && key->nb_sizes < POLYBENCH_DATASET_MAX_SIZES)
+    {
+      key->sizes[key->nb_sizes] = va_arg (ap, int);
+      len = strlen (polybench_dataset_path);
+      snprintf (polybench_dataset_path + len,
+		sizeof(polybench_dataset_path) - len,
+		"%s%s%d", key->nb_sizes ? "_" : ".", name,
+		key->sizes[key->nb_sizes]);
+      key->nb_sizes++;
+    }
+  len = strlen (polybench_dataset_path);
+  snprintf (polybench_dataset_path + len,
+	    sizeof(polybench_dataset_path) - len, ".dataset");
+}
+
+
+static
+void polybench_dataset_unmap()
+{
+  if (polybench_dataset_map != NULL)
+    munmap (polybench_dataset_map, polybench_dataset_map_size);
+  polybench_dataset_map = NULL;
+  polybench_dataset_map_size = 0;
+}
+
+
+/* Map the cache file and check it against the key. */
+static
+int polybench_dataset_map_file()
+{
+  struct polybench_dataset_header* key = &polybench_dataset_key;
+  struct polybench_dataset_header header;
+  char* entries[POLYBENCH_DATASET_MAX_ENTRIES];
+  size_t size = polybench_dataset_offset (key->nb_entries);
+  int flags = MAP_PRIVATE;
+  struct stat st;
+  char* map;
+  int fd;
+  int i;
+
+  fd = open (polybench_dataset_path, O_RDONLY);
+  if (fd < 0)
+    return 0;
+  if (fstat (fd, &st) != 0 || (size_t) st.st_size != size)
+    {
+      close (fd);
+      return 0;
+    }
+# if defined(POLYBENCH_DATASET_POPULATE) && defined(MAP_POPULATE)
+  flags |= MAP_POPULATE;
+# endif
+  map = (char*) mmap (NULL, size, PROT_READ, flags, fd, 0);
+  close (fd);
+  if (map == MAP_FAILED)
+    return 0;
+# if defined(POLYBENCH_DATASET_POPULATE) && defined(MADV_HUGEPAGE)
+  madvise (map, size, MADV_HUGEPAGE);
+# elif defined(MADV_SEQUENTIAL)
+  madvise (map, size, MADV_SEQUENTIAL);
+# endif
+  memcpy (&header, map, sizeof(header));
+  for (i = 0; i < key->nb_entries; i++)
+    entries[i] = map + polybench_dataset_offset (i);
+  key->checksum = header.checksum;
+  if (memcmp (&header, key, sizeof(header))
+      || polybench_dataset_checksum (entries) != header.checksum)
+    {
+      fprintf (stderr, "[PolyBench] dataset cache: %s does not match, recomputing\n",
+	       polybench_dataset_path);
+      munmap (map, size);
+      return 0;
+    }
+  polybench_dataset_map = map;
+  polybench_dataset_map_size = size;
+  fprintf (stderr, "[PolyBench] dataset cache: loaded %s\n",
+	   polybench_dataset_path);
+
+  return 1;
+}
+
+
+/* Called in place of the initialization, with a NULL-terminated list
+   of (name, value) pairs for the problem sizes. Returns 1 if the
+   registered data were loaded from the cache. */
+int polybench_dataset_read(const char* file, const char* data_type, ...)
+{
+  va_list ap;
+  int i;
+
+  if (polybench_dataset_enabled < 0)
+    {
+      va_start (ap, data_type);
+      polybench_dataset_init (file, data_type, ap);
+      va_end (ap);
+    }
+  if (! polybench_dataset_enabled)
+    return 0;
+  if (polybench_dataset_map == NULL && ! polybench_dataset_map_file ())
+    return 0;
+  for (i = 0; i < polybench_dataset_key.nb_entries; i++)
+    memcpy (polybench_dataset_ptr[i],
+	    polybench_dataset_map + polybench_dataset_offset (i),
+	    polybench_dataset_key.entry_size[i]);
+
+  return 1;
+}
+
+
+/* Called after the initialization: write the registered data to a
+   temporary file, renamed into place so that concurrent executions
+   never map a partial file. */
+void polybench_dataset_write()
+{
+  struct polybench_dataset_header* key = &polybench_dataset_key;
+  char header[POLYBENCH_DATASET_HEADER_SIZE];
+  char pad[POLYBENCH_DATASET_ALIGNMENT];
+  char tmp[sizeof(polybench_dataset_path) + 32];
+  FILE* f;
+  int ok;
+  int i;
+
+  if (! polybench_dataset_enabled)
+    return;
+  polybench_dataset_unmap ();
+  key->checksum = polybench_dataset_checksum ((char* const*) polybench_dataset_ptr);
+  memset (header, 0, sizeof(header));
+  memcpy (header, key, sizeof(*key));
+  memset (pad, 0, sizeof(pad));
+  snprintf (tmp, sizeof(tmp), "%s.%ld", polybench_dataset_path,
+	    (long) getpid ());
+  f = fopen (tmp, "wb");
+  ok = f != NULL && fwrite (header, sizeof(header), 1, f) == 1;
+  for (i = 0; ok && i < key->nb_entries; i++)
+    {
+      size_t rem = key->entry_size[i] % POLYBENCH_DATASET_ALIGNMENT;
+      ok = fwrite (polybench_dataset_ptr[i], 1, key->entry_size[i], f)
+	== key->entry_size[i];
+      if (ok && rem)
+	ok = fwrite (pad, 1, POLYBENCH_DATASET_ALIGNMENT - rem, f)
+	  == POLYBENCH_DATASET_ALIGNMENT - rem;
+    }
+  if (f != NULL && fclose (f) != 0)
+    ok = 0;
+  if (ok && rename (tmp, polybench_dataset_path) == 0)
+    fprintf (stderr, "[PolyBench] dataset cache: stored %s\n",
+	     polybench_dataset_path);
+  else
+    {
+      fprintf (stderr, "[PolyBench] dataset cache: cannot write %s\n",
+	       polybench_dataset_path);
+      unlink (tmp);
+      /* Do not retry at every repetition. */
+      polybench_dataset_enabled = 0;
+    }
+}
+#endif
+
+
+#if defined(POLYBENCH_CHECKSUM) || defined(POLYBENCH_VERIFY)
+/* Element type of the arrays of the checksum and verification modes,
+   from the name of DATA_TYPE: 'd', 'f' or 'i'. */
+static
+int polybench_elt_type(const char* data_type)
+{
+  return ! strcmp (data_type, "float") ? 'f'
+    : ! strcmp (data_type, "int") ? 'i' : 'd';
 }
 
+
+/* Element i of the array at base, as a double. */
+static
+double polybench_elt_value(const void* base, long i, int type)
+{
+  switch (type)
+    {
+    case 'f': return ((const float*) base)[i];
+    case 'i': return ((const int*) base)[i];
+    default: return ((const double*) base)[i];
+    }
+}
 #endif
-/* ! POLYBENCH_PAPI */
 
-void polybench_prepare_instruments()
+
+#ifdef POLYBENCH_CHECKSUM
+/*
+ * Checksums of the live-out arrays, printed by print_array instead of
+ * their elements. For an n x m array of pitch elements per row, the
+ * fingerprint is the number of elements, their sum, their L2 norm,
+ * their largest magnitude, and a hash of the values quantized to
+ * POLYBENCH_CHECKSUM_TOLERANCE times that magnitude. The hash of each
+ * element depends on its index; the hashes are added, so that the
+ * threads can reduce them in any order. The sums are accumulated in
+ * double precision, in an order which depends on the schedule, and are
+ * compared with a tolerance; equal hashes mean that the arrays agree
+ * within the tolerance, except for the values which straddle the
+ * boundary of a quantum.
+ */
+/* Finalizer of splitmix64. */
+static
+unsigned long long polybench_checksum_mix(unsigned long long x)
 {
-#ifndef POLYBENCH_NO_FLUSH_CACHE
-  polybench_flush_cache ();
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+
+void polybench_checksum_array(const char* name, const void* data,
+			      long n, long m, long pitch,
+			      const char* data_type)
+{
+  int type = polybench_elt_type (data_type);
+  double sum = 0, sq = 0, max = 0, quantum;
+  unsigned long long hash = 0;
+  long i;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+:sum,sq) reduction(max:max)
 #endif
-#ifdef POLYBENCH_LINUX_FIFO_SCHEDULER
-  polybench_linux_fifo_scheduler ();
+  for (i = 0; i < n; i++)
+    {
+      long j;
+      for (j = 0; j < m; j++)
+	{
+	  double v = polybench_elt_value (data, i * pitch + j, type);
+	  sum += v;
+	  sq += v * v;
+	  if (fabs (v) > max || v != v)
+	    max = fabs (v);
+	}
+    }
+  /* Integers are hashed exactly. */
+  quantum = type == 'i' || max == 0 || max != max ? 1
+    : POLYBENCH_CHECKSUM_TOLERANCE * max;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(+:hash)
 #endif
+  for (i = 0; i < n; i++)
+    {
+      long j;
+      for (j = 0; j < m; j++)
+	{
+	  double r = polybench_elt_value (data, i * pitch + j, type) / quantum;
+	  long long q = fabs (r) < 9e18 ? llround (r) : LLONG_MAX;
+	  hash += polybench_checksum_mix ((unsigned long long) (i * m + j)
+					  * 0x9e3779b97f4a7c15ULL
+					  ^ (unsigned long long) q);
+	}
+    }
+  fprintf (POLYBENCH_DUMP_TARGET,
+	   "checksum: %s elements=%ld sum=%.15e l2=%.15e max=%.15e hash=%016llx tolerance=%g\n",
+	   name, n * m, sum, sqrt (sq), max, hash,
+	   (double) POLYBENCH_CHECKSUM_TOLERANCE);
 }
+#endif
 
 
-void polybench_timer_start()
+
+
+#ifdef POLYBENCH_VERIFY
+/*
+ * Verification against a reference implementation. The program keeps a
+ * copy of the inputs of the last run, runs the reference on it after
+ * the timed runs, and compares the results element by element: the
+ * largest absolute error, the largest error relative to each reference
+ * element (the elements equal to zero aside), and the largest distance
+ * in units in the last place. The check passes if the largest absolute
+ * error is at most TOLERANCE machine epsilons of DATA_TYPE times the
+ * largest magnitude of the reference: the reorderings of the sums in
+ * the optimized variants pass, an accumulated drift does not. Integer
+ * results must be equal. Each check prints one line on stderr, and the
+ * program exits with status 1 if one of them failed.
+ */
+# include <float.h>
+# include <stdint.h>
+
+static int polybench_verify_failures = 0;
+
+
+static
+double polybench_verify_epsilon(int type)
 {
-  polybench_prepare_instruments ();
-#ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
-  polybench_t_start = rtclock ();
-#else
-  polybench_c_start = rdtsc ();
-#endif
+  return type == 'd' ? DBL_EPSILON : type == 'f' ? FLT_EPSILON : 0;
 }
 
 
-void polybench_timer_stop()
+/* Distance between a[i] and b[k] in units in the last place, through
+   the integers which order the floating point values. */
+static
+double polybench_verify_ulps(const void* a, long i, const void* b, long k,
+			     int type)
 {
-#ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
-  polybench_t_end = rtclock ();
-#else
-  polybench_c_end = rdtsc ();
-#endif
-#ifdef POLYBENCH_LINUX_FIFO_SCHEDULER
-  polybench_linux_standard_scheduler ();
-#endif
+  if (type == 'f')
+    {
+      int32_t x, y;
+      memcpy (&x, (const float*) a + i, sizeof(x));
+      memcpy (&y, (const float*) b + k, sizeof(y));
+      x = x < 0 ? INT32_MIN - x : x;
+      y = y < 0 ? INT32_MIN - y : y;
+      return x > y ? (double) ((uint32_t) x - (uint32_t) y)
+	: (double) ((uint32_t) y - (uint32_t) x);
+    }
+  if (type == 'd')
+    {
+      int64_t x, y;
+      memcpy (&x, (const double*) a + i, sizeof(x));
+      memcpy (&y, (const double*) b + k, sizeof(y));
+      x = x < 0 ? INT64_MIN - x : x;
+      y = y < 0 ? INT64_MIN - y : y;
+      return x > y ? (double) ((uint64_t) x - (uint64_t) y)
+	: (double) ((uint64_t) y - (uint64_t) x);
+    }
+  return fabs (polybench_elt_value (a, i, type)
+	       - polybench_elt_value (b, k, type));
 }
 
 
-void polybench_timer_print()
+/* Print the outcome of a check, whose error is relative to the scale
+   of the result. */
+static
+int polybench_verify_report(double error, int type, double tolerance)
 {
-#ifdef POLYBENCH_GFLOPS
-      if  (polybench_program_total_flops == 0)
+  double eps = polybench_verify_epsilon (type);
+  int pass = error <= tolerance * eps;
+
+  if (eps > 0)
+    fprintf (stderr, "%0.2f eps (tolerance %g eps): %s\n", error / eps,
+	     tolerance, pass ? "pass" : "FAIL");
+  else
+    fprintf (stderr, "%g (exact): %s\n", error, pass ? "pass" : "FAIL");
+  if (! pass)
+    polybench_verify_failures++;
+
+  return pass;
+}
+
+
+int polybench_verify_array(const char* name, const void* data,
+			   const void* ref, long n, long m,
+			   long pitch, long ref_pitch,
+			   const char* data_type, double tolerance)
+{
+  int type = polybench_elt_type (data_type);
+  double max_abs = 0, max_rel = 0, max_ulps = 0, max_ref = 0;
+  long i, j;
+
+  for (i = 0; i < n; i++)
+    for (j = 0; j < m; j++)
+      {
+	double v = polybench_elt_value (data, i * pitch + j, type);
+	double r = polybench_elt_value (ref, i * ref_pitch + j, type);
+	double d = v == v ? fabs (v - r) : HUGE_VAL;
+	double u = polybench_verify_ulps (data, i * pitch + j,
+					 ref, i * ref_pitch + j, type);
+	if (d > max_abs)
+	  max_abs = d;
+	if (r != 0 && d / fabs (r) > max_rel)
+	  max_rel = d / fabs (r);
+	if (u > max_ulps)
+	  max_ulps = u;
+	if (fabs (r) > max_ref)
+	  max_ref = fabs (r);
+      }
+  fprintf (stderr, "[PolyBench] verify %s: max abs err %.3e, max rel err %.3e, max %.0f ulp, normwise ",
+	   name, max_abs, max_rel, max_ulps);
+
+  return polybench_verify_report (max_ref > 0 ? max_abs / max_ref : max_abs,
+				  type, tolerance);
+}
+
+
+/* Normwise backward error of the solution x of the n x n system
+   A x = b, ||b - A x|| / (||A|| ||x|| + ||b||) in the infinity norm,
+   with the residual accumulated in long double. */
+int polybench_verify_residual(const char* name, const void* A,
+			      const void* x, const void* b, long n,
+			      long pitch, const char* data_type,
+			      double tolerance)
+{
+  int type = polybench_elt_type (data_type);
+  double norm_r = 0, norm_a = 0, norm_x = 0, norm_b = 0, scale;
+  long i, j;
+
+  for (i = 0; i < n; i++)
+    {
+      double bi = polybench_elt_value (b, i, type);
+      double xi = polybench_elt_value (x, i, type);
+      long double r = bi;
+      double row = 0;
+      for (j = 0; j < n; j++)
 	{
-	  printf ("[PolyBench][WARNING] Program flops not defined, use polybench_set_program_flops(value)\n");
-	  printf ("%0.6lf\n", polybench_t_end - polybench_t_start);
+	  double a = polybench_elt_value (A, i * pitch + j, type);
+	  r -= (long double) a * polybench_elt_value (x, j, type);
+	  row += fabs (a);
 	}
-      else
-	printf ("%0.2lf\n",
-		(polybench_program_total_flops /
-		 (double)(polybench_t_end - polybench_t_start)) / 1000000000);
-#else
-# ifndef POLYBENCH_CYCLE_ACCURATE_TIMER
-      printf ("%0.6f\n", polybench_t_end - polybench_t_start);
-# else
-      printf ("%Ld\n", polybench_c_end - polybench_c_start);
-# endif
-#endif
+      norm_r = r == r ? fmax (norm_r, fabs ((double) r)) : HUGE_VAL;
+      norm_a = fmax (norm_a, row);
+      norm_x = fmax (norm_x, fabs (xi));
+      norm_b = fmax (norm_b, fabs (bi));
+    }
+  scale = norm_a * norm_x + norm_b;
+  fprintf (stderr, "[PolyBench] verify %s: residual ||b-Ax|| %.3e, backward error ",
+	   name, norm_r);
+
+  return polybench_verify_report (scale > 0 ? norm_r / scale : norm_r,
+				  type, tolerance);
+}
+
+
+/* Exit status of the program. */
+int polybench_verify_status()
+{
+  return polybench_verify_failures > 0;
 }
+#endif
 
+
+#ifdef POLYBENCH_RUNTIME_SIZES
 /*
- * These functions are used only if the user defines a specific
- * inter-array padding. It grows a global structure,
- * _polybench_alloc_table, which keeps track of the data allocated via
- * polybench_alloc_data (on which inter-array padding is applied), so
- * that the original, non-shifted pointer can be recovered when
- * calling polybench_free_data.
- *
+ * Run-time problem sizes. The size NAME is taken from the first
+ * argument NAME=value of the program, else from the environment
+ * variable POLYBENCH_NAME, else from its compile-time value. The other
+ * arguments are ignored. An invalid value stops the program.
  */
-#ifdef POLYBENCH_ENABLE_INTARRAY_PAD
-static
-void grow_alloc_table()
+int polybench_runtime_size(const char* name, int def, int argc, char** argv)
 {
-  if (_polybench_alloc_table == NULL ||
-      (_polybench_alloc_table->nb_entries % NB_INITIAL_TABLE_ENTRIES) != 0 ||
-      _polybench_alloc_table->nb_avail_entries != 0)
+  size_t len = strlen (name);
+  const char* value = NULL;
+  char env[64];
+  char* end;
+  long v;
+  int i;
+
+  for (i = 1; i < argc && value == NULL; i++)
+    if (! strncmp (argv[i], name, len) && argv[i][len] == '=')
+      value = argv[i] + len + 1;
+  if (value == NULL)
     {
-      /* Should never happen if the API is properly used. */
-      fprintf (stderr, "[ERROR] Inter-array padding requires to use polybench_alloc_data and polybench_free_data\n");
+      snprintf (env, sizeof(env), "POLYBENCH_%s", name);
+      value = getenv (env);
+    }
+  if (value == NULL)
+    return def;
+  v = strtol (value, &end, 10);
+  if (end == value || *end != '\0' || v <= 0 || v > INT_MAX)
+    {
+      fprintf (stderr, "[PolyBench] invalid size %s=%s\n", name, value);
       exit (1);
     }
-  size_t sz = _polybench_alloc_table->nb_entries;
-  sz += NB_INITIAL_TABLE_ENTRIES;
-  _polybench_alloc_table->user_view =
-    realloc (_polybench_alloc_table->user_view, sz * sizeof(void*));
-  assert(_polybench_alloc_table->user_view != NULL);
-  _polybench_alloc_table->real_ptr =
-    realloc (_polybench_alloc_table->real_ptr, sz * sizeof(void*));
-  assert(_polybench_alloc_table->real_ptr != NULL);
-  _polybench_alloc_table->nb_avail_entries = NB_INITIAL_TABLE_ENTRIES;
+
+  return (int) v;
 }
+#endif
+
+
+#ifdef POLYBENCH_AFFINITY
+/*
+ * Thread affinity, with -DPOLYBENCH_AFFINITY=<policy>, or the
+ * POLYBENCH_AFFINITY environment variable, which overrides it:
+ *   compact: thread i on the i-th CPU in compact order (SMT siblings
+ *            first, then the cores of an L3 domain, then the domains);
+ *   scatter: the threads spread over the packages, then over the L3
+ *            domains, then over the cores, SMT siblings last;
+ *   core:    one thread per core, on its first SMT sibling, in
+ *            compact order; the other siblings only once every core
+ *            has a thread;
+ *   ccx:     one thread per L3 domain, round-robin, each thread being
+ *            free to run on any CPU of its domain.
+ * Under MPI, the CPUs of the node are first split into as many
+ * contiguous sets, in compact order, as there are ranks on the node,
+ * from the local rank and size set by the launcher; each rank is bound
+ * to its set, in which its threads are placed. The threads are bound
+ * in a parallel region of the default size, whose threads the OpenMP
+ * runtime reuses for the parallel regions of the kernel. The policy is
+ * applied once, before the first allocation or run.
+ */
+static const char* polybench_affinity_policy = NULL;
 
 static
-void* register_padded_pointer(void* ptr, size_t orig_sz, size_t padded_sz)
+const char* polybench_affinity_name()
 {
-  if (_polybench_alloc_table == NULL)
-    {
-      fprintf (stderr, "[ERROR] Inter-array padding requires to use polybench_alloc_data and polybench_free_data\n");
-      exit (1);
-    }
-  if (_polybench_alloc_table->nb_avail_entries == 0)
-    grow_alloc_table ();
-  int id = _polybench_alloc_table->nb_entries++;
-  _polybench_alloc_table->real_ptr[id] = ptr;
-  _polybench_alloc_table->user_view[id] = ptr + (padded_sz - orig_sz);
+  const char* env = getenv ("POLYBENCH_AFFINITY");
 
-  return _polybench_alloc_table->user_view[id];
+  if (env != NULL && *env)
+    return env;
+  return POLYBENCH_STRINGIFY(POLYBENCH_AFFINITY);
 }
 
 
+/* Local rank and number of ranks on the node, from the launcher. */
 static
-void
-free_data_from_alloc_table (void* ptr)
+void polybench_local_rank(int* rank, int* size)
 {
-  if (_polybench_alloc_table != NULL && _polybench_alloc_table->nb_entries > 0)
-    {
-      int i;
-      for (i = 0; i < _polybench_alloc_table->nb_entries; ++i)
-	if (_polybench_alloc_table->user_view[i] == ptr ||
-	    _polybench_alloc_table->real_ptr[i] == ptr)
-	  break;
-      if (i != _polybench_alloc_table->nb_entries)
-	{
-	  free (_polybench_alloc_table->real_ptr[i]);
-	  for (; i < _polybench_alloc_table->nb_entries - 1; ++i)
-	    {
-	      _polybench_alloc_table->user_view[i] =
-		_polybench_alloc_table->user_view[i + 1];
-	      _polybench_alloc_table->real_ptr[i] =
-		_polybench_alloc_table->real_ptr[i + 1];
-	    }
-	  _polybench_alloc_table->nb_entries--;
-	  _polybench_alloc_table->nb_avail_entries++;
-	  if (_polybench_alloc_table->nb_entries == 0)
-	    {
-	      free (_polybench_alloc_table->user_view);
-	      free (_polybench_alloc_table->real_ptr);
-	      free (_polybench_alloc_table);
-	      _polybench_alloc_table = NULL;
-	    }
-	}
-    }
+  static const char* const rank_vars[] =
+    { "OMPI_COMM_WORLD_LOCAL_RANK", "MPI_LOCALRANKID",
+      "MV2_COMM_WORLD_LOCAL_RANK", "SLURM_LOCALID", NULL };
+  static const char* const size_vars[] =
+    { "OMPI_COMM_WORLD_LOCAL_SIZE", "MPI_LOCALNRANKS",
+      "MV2_COMM_WORLD_LOCAL_SIZE", "SLURM_NTASKS_PER_NODE", NULL };
+  int i;
+
+  *rank = 0;
+  *size = 1;
+  for (i = 0; rank_vars[i] != NULL; ++i)
+    if (getenv (rank_vars[i]) != NULL && getenv (size_vars[i]) != NULL)
+      {
+	*rank = atoi (getenv (rank_vars[i]));
+	*size = atoi (getenv (size_vars[i]));
+	break;
+      }
+  if (*size < 1 || *rank < 0 || *rank >= *size)
+    *rank = 0, *size = 1;
 }
 
+
+/* Keep the CPUs of the local rank, and bind the process to them. */
 static
-void check_alloc_table_state()
+void polybench_affinity_split(int rank, int size)
 {
-  if (_polybench_alloc_table == NULL)
+  int first = (long) polybench_nb_cpus * rank / size;
+  int last = (long) polybench_nb_cpus * (rank + 1) / size;
+  cpu_set_t set;
+  int i;
+
+  if (size == 1)
+    return;
+  if (last == first)
+    last = first + 1;
+  CPU_ZERO (&set);
+  for (i = first; i < last; ++i)
     {
-      _polybench_alloc_table = (struct polybench_data_ptrs*)
-	malloc (sizeof(struct polybench_data_ptrs));
-      assert(_polybench_alloc_table != NULL);
-      _polybench_alloc_table->user_view =
-	(void**) malloc (sizeof(void*) * NB_INITIAL_TABLE_ENTRIES);
-      assert(_polybench_alloc_table->user_view != NULL);
-      _polybench_alloc_table->real_ptr =
-	(void**) malloc (sizeof(void*) * NB_INITIAL_TABLE_ENTRIES);
-      assert(_polybench_alloc_table->real_ptr != NULL);
-      _polybench_alloc_table->nb_entries = 0;
-      _polybench_alloc_table->nb_avail_entries = NB_INITIAL_TABLE_ENTRIES;
+      polybench_cpus[i - first] = polybench_cpus[i];
+      CPU_SET (polybench_cpus[i - first].cpu, &set);
     }
+  polybench_nb_cpus = last - first;
+  polybench_rank_cpus ();
+  sched_setaffinity (0, sizeof(set), &set);
 }
 
-#endif // !POLYBENCH_ENABLE_INTARRAY_PAD
+
+static
+int polybench_affinity_known(const char* policy)
+{
+  return ! strcmp (policy, "compact") || ! strcmp (policy, "scatter")
+    || ! strcmp (policy, "core") || ! strcmp (policy, "ccx");
+}
 
 
+/* CPUs of thread T. */
 static
-void*
-xmalloc(size_t alloc_sz)
+void polybench_affinity_target(const char* policy, int t, cpu_set_t* set)
 {
-  void* ret = NULL;
-  /* By default, post-pad the arrays. Safe behavior, but likely useless. */
-  polybench_inter_array_padding_sz += POLYBENCH_INTER_ARRAY_PADDING_FACTOR;
-  size_t padded_sz = alloc_sz + polybench_inter_array_padding_sz;
-  int err = posix_memalign (&ret, 4096, padded_sz);
-  if (! ret || err)
+  int i, l3 = 0;
+
+  CPU_ZERO (set);
+  if (strcmp (policy, "ccx"))
     {
-      fprintf (stderr, "[PolyBench] posix_memalign: cannot allocate memory");
-      exit (1);
+      CPU_SET (polybench_cpus[t % polybench_nb_cpus].cpu, set);
+      return;
+    }
+  /* The CPUs are in compact order: the domain of T is the T-th one,
+     modulo the number of domains. */
+  for (i = 0; i < polybench_nb_cpus; ++i)
+    {
+      l3 += i > 0 && (polybench_cpus[i].l3 != polybench_cpus[i - 1].l3
+		      || polybench_cpus[i].package
+		      != polybench_cpus[i - 1].package);
+      if (l3 == t % polybench_nb_l3)
+	CPU_SET (polybench_cpus[i].cpu, set);
     }
-  /* Safeguard: this is invoked only if polybench.c has been compiled
-     with inter-array padding support from polybench.h. If so, move
-     the starting address of the allocation and return it to the
-     user. The original pointer is registered in an allocation table
-     internal to polybench.c. Data must then be freed using
-     polybench_free_data, which will inspect the allocation table to
-     free the original pointer.*/
-#ifdef POLYBENCH_ENABLE_INTARRAY_PAD
-  /* This moves the 'ret' pointer by (padded_sz - alloc_sz) positions, and
-  registers it in the lookup table for future free using
-  polybench_free_data. */
-  ret = register_padded_pointer(ret, alloc_sz, padded_sz);
-#endif
-
-  return ret;
 }
 
 
-void polybench_free_data(void* ptr)
+static
+void polybench_affinity_apply()
 {
-#ifdef POLYBENCH_ENABLE_INTARRAY_PAD
-  free_data_from_alloc_table (ptr);
+  const char* policy = polybench_affinity_name ();
+  char buf[4096], list[256];
+  cpu_set_t set;
+  int rank, size, nb = 1, t;
+  size_t len;
+
+  if (polybench_affinity_policy != NULL)
+    return;
+  polybench_affinity_policy = policy;
+  if (! strcmp (policy, "none"))
+    return;
+  if (! polybench_affinity_known (policy))
+    {
+      fprintf (stderr, "[PolyBench][WARNING] Unknown affinity policy %s,"
+	       " threads not bound\n", policy);
+      polybench_affinity_policy = "none";
+      return;
+    }
+  polybench_read_topology ();
+  polybench_local_rank (&rank, &size);
+  polybench_affinity_split (rank, size);
+  if (! strcmp (policy, "scatter"))
+    polybench_sort_cpus (POLYBENCH_CPU_SMT, POLYBENCH_CPU_CORE_RANK,
+			 POLYBENCH_CPU_L3_RANK, POLYBENCH_CPU_PACKAGE);
+  else if (! strcmp (policy, "core"))
+    polybench_sort_cpus (POLYBENCH_CPU_SMT, POLYBENCH_CPU_PACKAGE,
+			 POLYBENCH_CPU_L3, POLYBENCH_CPU_CORE);
+#ifdef _OPENMP
+  nb = omp_get_max_threads ();
+#pragma omp parallel private(set)
+  {
+    polybench_affinity_target (policy, omp_get_thread_num (), &set);
+    sched_setaffinity (0, sizeof(set), &set);
+  }
 #else
-  free (ptr);
+  polybench_affinity_target (policy, 0, &set);
+  sched_setaffinity (0, sizeof(set), &set);
 #endif
+
+  /* One line: the policy, the CPUs of the rank and their topology,
+     and the CPUs of each thread. */
+  polybench_cpu_set_string (list, sizeof(list));
+  len = snprintf (buf, sizeof(buf), "[PolyBench] affinity: %s, rank %d/%d"
+		  " on cpus %s (%d packages, %d L3 domains, %d cores,"
+		  " %d cpus), threads", policy, rank, size, list,
+		  polybench_nb_packages, polybench_nb_l3, polybench_nb_cores,
+		  polybench_nb_cpus);
+  for (t = 0; t < nb && len < sizeof(buf); ++t)
+    {
+      polybench_affinity_target (policy, t, &set);
+      polybench_format_cpu_set (&set, list, sizeof(list));
+      len += snprintf (buf + len, sizeof(buf) - len, " %d:%s", t, list);
+    }
+  fprintf (stderr, "%s\n", buf);
 }
 
 
-void* polybench_alloc_data(unsigned long long int n, int elt_size)
+/* Report, on stderr, the CPU of each thread at the end of the runs. */
+static
+void polybench_print_thread_cpus()
 {
-#ifdef POLYBENCH_ENABLE_INTARRAY_PAD
-  check_alloc_table_state ();
+  int t;
+
+  fprintf (stderr, "[PolyBench] thread cpus:");
+  for (t = 0; t < polybench_nb_thread_cpus; ++t)
+    fprintf (stderr, " %d:%d", t, polybench_thread_cpus[t]);
+  fprintf (stderr, " (%d migrations)\n", polybench_thread_migrations);
+}
 #endif
 
-  /// FIXME: detect overflow!
-  size_t val = n;
-  val *= elt_size;
-  void* ret = xmalloc (val);
 
-  return ret;
+#ifdef POLYBENCH_DRIVER
+/*
+ * Multi-kernel driver: reset the state which polybench.c keeps for the
+ * program, so that the next kernel starts as in a new process. The
+ * region profile of the previous kernel is printed first. The
+ * allocator, the scratch arenas, the flush buffer and the timer
+ * calibration are kept.
+ */
+void polybench_program_reset()
+{
+#ifdef POLYBENCH_REGIONS
+  polybench_region_print ();
+  polybench_nb_regions = 0;
+#endif
+  polybench_nb_samples = 0;
+  polybench_program_total_flops = 0;
+  polybench_program_total_bytes = 0;
+  polybench_layout_time = 0;
+  polybench_layout_nb = 0;
+#ifdef POLYBENCH_RECORD
+  polybench_program_file = NULL;
+  polybench_program_kernel = NULL;
+  polybench_nb_sizes = 0;
+#endif
+#ifdef POLYBENCH_MEMORY_REPORT
+  polybench_memory_scratch_peak = polybench_memory_scratch;
+  polybench_memory_high_water =
+    polybench_memory_arrays + polybench_memory_scratch;
+#endif
+#ifdef POLYBENCH_DATASET_CACHE
+  polybench_dataset_unmap ();
+  memset (&polybench_dataset_key, 0, sizeof(polybench_dataset_key));
+  polybench_dataset_enabled = -1;
+#endif
+#ifdef POLYBENCH_VERIFY
+  polybench_verify_failures = 0;
+#endif
+#if defined(POLYBENCH_AFFINITY) || defined(POLYBENCH_RECORD)
+  polybench_nb_thread_cpus = 0;
+  polybench_thread_migrations = 0;
+#endif
 }
+#endif
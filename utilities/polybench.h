@@ -19,6 +19,12 @@
  * -DPOLYBENCH_TIME, to report the execution time,
  *   OR (exclusive):
  * -DPOLYBENCH_PAPI, to use PAPI H/W counters (defined in polybench.c)
+ *   OR (exclusive):
+ * -DPOLYBENCH_PERF, to use Linux perf_event H/W counters (defined in
+ *   polybench.c)
+ *
+ * -DPOLYBENCH_REGIONS, to profile the regions delimited by
+ *   polybench_region_begin/end (with any of the above)
  *
  *
  * See README or utilities/polybench.c for additional options.
@@ -35,6 +41,54 @@
 #  define POLYBENCH_PADDING_FACTOR 0
 # endif
 
+/* Row pitch of the multi-dimensional arrays. With POLYBENCH_ROW_ALIGNMENT
+   (in bytes), the last dimension of the 2D to 5D arrays, padding
+   included, is rounded up to a multiple of that size, so that every
+   row starts on such a boundary. Their logical dimensions, used by the
+   loops, are unchanged. By default, rows are not aligned. */
+# ifdef POLYBENCH_ROW_ALIGNMENT
+#  define POLYBENCH_ROW_PITCH_ELTS					\
+  (POLYBENCH_ROW_ALIGNMENT >= sizeof(DATA_TYPE) ?			\
+   POLYBENCH_ROW_ALIGNMENT / sizeof(DATA_TYPE) : 1)
+#  define POLYBENCH_ROW_PITCH(n)					\
+  (((n) + POLYBENCH_PADDING_FACTOR + POLYBENCH_ROW_PITCH_ELTS - 1)	\
+   / POLYBENCH_ROW_PITCH_ELTS * POLYBENCH_ROW_PITCH_ELTS)
+# else
+/* default: */
+#  define POLYBENCH_ROW_PITCH(n) (n + POLYBENCH_PADDING_FACTOR)
+# endif
+
+/* Automatic anti-aliasing padding. With POLYBENCH_AUTO_PADDING, the row
+   pitch of the heap arrays and their starting offsets are chosen at
+   run time from the geometry of the caches (see polybench.c), so that
+   the column walks are not mapped to a few cache sets when the sizes
+   are powers of two. The arrays are then variable-length arrays. */
+# if defined(POLYBENCH_AUTO_PADDING) && ! defined(POLYBENCH_STACK_ARRAYS)
+#  ifndef POLYBENCH_ROW_ALIGNMENT
+#   define POLYBENCH_ROW_ALIGNMENT 0
+#  endif
+#  undef POLYBENCH_ROW_PITCH
+#  define POLYBENCH_ROW_PITCH(n)					\
+  polybench_auto_row_pitch ((n) + POLYBENCH_PADDING_FACTOR,		\
+			    sizeof(DATA_TYPE), POLYBENCH_ROW_ALIGNMENT)
+#  undef POLYBENCH_ENABLE_INTARRAY_PAD
+#  define POLYBENCH_ENABLE_INTARRAY_PAD
+extern long polybench_auto_row_pitch(long n, unsigned long elt_size,
+				     unsigned long alignment);
+# endif
+
+/* Leading dimension (row pitch) of the 2D array A, in elements, e.g.
+   for BLAS and LAPACK. */
+# define POLYBENCH_LEADING_DIM(A) (sizeof((A)[0]) / sizeof((A)[0][0]))
+
+/* Alignment of the heap arrays, in bytes. polybench_alloc_data returns
+   page-aligned memory; with inter-array padding, the offset of each
+   array is rounded up to a multiple of this value. */
+# ifndef POLYBENCH_ALIGNMENT
+/* default: */
+#  define POLYBENCH_ALIGNMENT 64
+# endif
+
 /* Inter-array padding, for use with . By default, none is used. */
 # ifndef POLYBENCH_INTER_ARRAY_PADDING_FACTOR
 /* default: */
@@ -44,6 +98,70 @@
 #  define POLYBENCH_ENABLE_INTARRAY_PAD
 # endif
 
+/* Arrays allocated with polybench_alloc_data are tracked in a table
+   when their real address differs from the user one, when they are
+   flushed individually from the cache, when they may be mapped on huge
+   pages, or when their NUMA placement or memory footprint is
+   reported. */
+# if defined(POLYBENCH_ENABLE_INTARRAY_PAD) || defined(POLYBENCH_FLUSH_CLFLUSHOPT) || defined(POLYBENCH_HUGEPAGES) || defined(POLYBENCH_NUMA) || defined(POLYBENCH_MEMORY_REPORT)
+#  define POLYBENCH_ALLOC_TABLE
+# endif
+
+/* With POLYBENCH_MEMORY_REPORT, the arrays declared with the
+   POLYBENCH_*_ARRAY_DECL macros are reported under their name. */
+# ifdef POLYBENCH_MEMORY_REPORT
+#  define POLYBENCH_NAME_ARRAY(var) polybench_name_data ((void*)var, #var);
+# else
+#  define POLYBENCH_NAME_ARRAY(var)
+# endif
+
+# define POLYBENCH_STRINGIFY_(x) #x
+# define POLYBENCH_STRINGIFY(x) POLYBENCH_STRINGIFY_(x)
+
+
+/* Multi-kernel driver. With POLYBENCH_DRIVER, the kernels are linked
+   into one executable (see utilities/driver-gen.pl) and read their
+   sizes at run time. The main function of a kernel compiled with
+   -DPOLYBENCH_KERNEL_ID=id is renamed polybench_main_id, which the
+   driver of utilities/polybench-driver.c calls after resetting the
+   state of polybench.c with polybench_program_reset. */
+# ifdef POLYBENCH_DRIVER
+#  ifndef POLYBENCH_RUNTIME_SIZES
+#   define POLYBENCH_RUNTIME_SIZES
+#  endif
+#  ifdef POLYBENCH_KERNEL_ID
+#   define POLYBENCH_CONCAT_(x,y) x##y
+#   define POLYBENCH_CONCAT(x,y) POLYBENCH_CONCAT_(x,y)
+#   define main POLYBENCH_CONCAT(polybench_main_, POLYBENCH_KERNEL_ID)
+#  endif
+extern void polybench_program_reset();
+# endif
+
+
+/* Run-time problem sizes. main reads each size with POLYBENCH_SIZE,
+   e.g. int n = POLYBENCH_SIZE(N);, or POLYBENCH_NAMED_SIZE when the
+   macro differs from the name of the size. With
+   POLYBENCH_RUNTIME_SIZES, an argument N=4000 or the environment
+   variable POLYBENCH_N=4000 overrides the compile-time value, which
+   remains the default, and the arrays are sized at run time (C99
+   variable-length arrays). */
+# ifdef POLYBENCH_RUNTIME_SIZES
+#  ifdef POLYBENCH_USE_SCALAR_LB
+#   error "POLYBENCH_RUNTIME_SIZES requires parametric loop bounds"
+#  endif
+#  ifndef POLYBENCH_USE_C99_PROTO
+#   define POLYBENCH_USE_C99_PROTO
+#  endif
+#  define POLYBENCH_NAMED_SIZE(name, x)		\
+  polybench_runtime_size (name, x, argc, argv)
+extern int polybench_runtime_size(const char* name, int def,
+				  int argc, char** argv);
+# else
+/* default: */
+#  define POLYBENCH_NAMED_SIZE(name, x) (x)
+# endif
+# define POLYBENCH_SIZE(x) POLYBENCH_NAMED_SIZE(#x, x)
+
 
 /* C99 arrays in function prototype. By default, do not use. */
 # ifdef POLYBENCH_USE_C99_PROTO
@@ -82,7 +200,7 @@
 */
 # ifndef POLYBENCH_STACK_ARRAYS
 #  define POLYBENCH_ARRAY(x) *x
-#  ifdef POLYBENCH_ENABLE_INTARRAY_PAD
+#  ifdef POLYBENCH_ALLOC_TABLE
 #   define POLYBENCH_FREE_ARRAY(x) polybench_free_data((void*)x);
 #  else
 #   define POLYBENCH_FREE_ARRAY(x) free((void*)x);
@@ -95,16 +213,16 @@
 # endif
 /* Macros for using arrays in the function prototypes. */
 # define POLYBENCH_1D(var, dim1,ddim1) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR]
-# define POLYBENCH_2D(var, dim1, dim2, ddim1, ddim2) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR]
-# define POLYBENCH_3D(var, dim1, dim2, dim3, ddim1, ddim2, ddim3) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR]
-# define POLYBENCH_4D(var, dim1, dim2, dim3, dim4, ddim1, ddim2, ddim3, ddim4) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim4,ddim4) + POLYBENCH_PADDING_FACTOR]
-# define POLYBENCH_5D(var, dim1, dim2, dim3, dim4, dim5, ddim1, ddim2, ddim3, ddim4, ddim5) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim4,ddim4) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim5,ddim5) + POLYBENCH_PADDING_FACTOR]
+# define POLYBENCH_2D(var, dim1, dim2, ddim1, ddim2) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(POLYBENCH_C99_SELECT(dim2,ddim2))]
+# define POLYBENCH_3D(var, dim1, dim2, dim3, ddim1, ddim2, ddim3) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(POLYBENCH_C99_SELECT(dim3,ddim3))]
+# define POLYBENCH_4D(var, dim1, dim2, dim3, dim4, ddim1, ddim2, ddim3, ddim4) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(POLYBENCH_C99_SELECT(dim4,ddim4))]
+# define POLYBENCH_5D(var, dim1, dim2, dim3, dim4, dim5, ddim1, ddim2, ddim3, ddim4, ddim5) var[POLYBENCH_RESTRICT POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim4,ddim4) + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(POLYBENCH_C99_SELECT(dim5,ddim5))]
 /* Macros for using arrays within the functions. */
 # define POLYBENCH_1D_F(var, dim1,ddim1) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR]
-# define POLYBENCH_2D_F(var, dim1, dim2, ddim1, ddim2) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR]
-# define POLYBENCH_3D_F(var, dim1, dim2, dim3, ddim1, ddim2, ddim3) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR]
-# define POLYBENCH_4D_F(var, dim1, dim2, dim3, dim4, ddim1, ddim2, ddim3, ddim4) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim4,ddim4) + POLYBENCH_PADDING_FACTOR]
-# define POLYBENCH_5D_F(var, dim1, dim2, dim3, dim4, dim5, ddim1, ddim2, ddim3, ddim4, ddim5) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim4,ddim4) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim5,ddim5) + POLYBENCH_PADDING_FACTOR]
+# define POLYBENCH_2D_F(var, dim1, dim2, ddim1, ddim2) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(POLYBENCH_C99_SELECT(dim2,ddim2))]
+# define POLYBENCH_3D_F(var, dim1, dim2, dim3, ddim1, ddim2, ddim3) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(POLYBENCH_C99_SELECT(dim3,ddim3))]
+# define POLYBENCH_4D_F(var, dim1, dim2, dim3, dim4, ddim1, ddim2, ddim3, ddim4) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(POLYBENCH_C99_SELECT(dim4,ddim4))]
+# define POLYBENCH_5D_F(var, dim1, dim2, dim3, dim4, dim5, ddim1, ddim2, ddim3, ddim4, ddim5) var[POLYBENCH_C99_SELECT(dim1,ddim1) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim2,ddim2) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim3,ddim3) + POLYBENCH_PADDING_FACTOR][POLYBENCH_C99_SELECT(dim4,ddim4) + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(POLYBENCH_C99_SELECT(dim5,ddim5))]
 
 
 /* Macros to allocate heap arrays.
@@ -115,31 +233,36 @@
 # define POLYBENCH_ALLOC_1D_ARRAY(n1, type)	\
   (type(*)[n1 + POLYBENCH_PADDING_FACTOR])polybench_alloc_data (n1 + POLYBENCH_PADDING_FACTOR, sizeof(type))
 # define POLYBENCH_ALLOC_2D_ARRAY(n1, n2, type)		\
-  (type(*)[n1 + POLYBENCH_PADDING_FACTOR][n2 + POLYBENCH_PADDING_FACTOR])polybench_alloc_data ((n1 + POLYBENCH_PADDING_FACTOR) * (n2 + POLYBENCH_PADDING_FACTOR), sizeof(type))
+  (type(*)[n1 + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(n2)])polybench_alloc_data ((n1 + POLYBENCH_PADDING_FACTOR) * POLYBENCH_ROW_PITCH(n2), sizeof(type))
 # define POLYBENCH_ALLOC_3D_ARRAY(n1, n2, n3, type)		\
-  (type(*)[n1 + POLYBENCH_PADDING_FACTOR][n2 + POLYBENCH_PADDING_FACTOR][n3 + POLYBENCH_PADDING_FACTOR])polybench_alloc_data ((n1 + POLYBENCH_PADDING_FACTOR) * (n2 + POLYBENCH_PADDING_FACTOR) * (n3 + POLYBENCH_PADDING_FACTOR), sizeof(type))
+  (type(*)[n1 + POLYBENCH_PADDING_FACTOR][n2 + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(n3)])polybench_alloc_data ((n1 + POLYBENCH_PADDING_FACTOR) * (n2 + POLYBENCH_PADDING_FACTOR) * POLYBENCH_ROW_PITCH(n3), sizeof(type))
 # define POLYBENCH_ALLOC_4D_ARRAY(n1, n2, n3, n4, type)			\
-  (type(*)[n1 + POLYBENCH_PADDING_FACTOR][n2 + POLYBENCH_PADDING_FACTOR][n3 + POLYBENCH_PADDING_FACTOR][n4 + POLYBENCH_PADDING_FACTOR])polybench_alloc_data ((n1 + POLYBENCH_PADDING_FACTOR) * (n2 + POLYBENCH_PADDING_FACTOR) * (n3 + POLYBENCH_PADDING_FACTOR) * (n4 + POLYBENCH_PADDING_FACTOR), sizeof(type))
+  (type(*)[n1 + POLYBENCH_PADDING_FACTOR][n2 + POLYBENCH_PADDING_FACTOR][n3 + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(n4)])polybench_alloc_data ((n1 + POLYBENCH_PADDING_FACTOR) * (n2 + POLYBENCH_PADDING_FACTOR) * (n3 + POLYBENCH_PADDING_FACTOR) * POLYBENCH_ROW_PITCH(n4), sizeof(type))
 # define POLYBENCH_ALLOC_5D_ARRAY(n1, n2, n3, n4, n5, type)		\
-  (type(*)[n1 + POLYBENCH_PADDING_FACTOR][n2 + POLYBENCH_PADDING_FACTOR][n3 + POLYBENCH_PADDING_FACTOR][n4 + POLYBENCH_PADDING_FACTOR][n5 + POLYBENCH_PADDING_FACTOR])polybench_alloc_data ((n1 + POLYBENCH_PADDING_FACTOR) * (n2 + POLYBENCH_PADDING_FACTOR) * (n3 + POLYBENCH_PADDING_FACTOR) * (n4 + POLYBENCH_PADDING_FACTOR) * (n5 + POLYBENCH_PADDING_FACTOR), sizeof(type))
+  (type(*)[n1 + POLYBENCH_PADDING_FACTOR][n2 + POLYBENCH_PADDING_FACTOR][n3 + POLYBENCH_PADDING_FACTOR][n4 + POLYBENCH_PADDING_FACTOR][POLYBENCH_ROW_PITCH(n5)])polybench_alloc_data ((n1 + POLYBENCH_PADDING_FACTOR) * (n2 + POLYBENCH_PADDING_FACTOR) * (n3 + POLYBENCH_PADDING_FACTOR) * (n4 + POLYBENCH_PADDING_FACTOR) * POLYBENCH_ROW_PITCH(n5), sizeof(type))
 
 /* Macros for array declaration. */
 # ifndef POLYBENCH_STACK_ARRAYS
 #  define POLYBENCH_1D_ARRAY_DECL(var, type, dim1, ddim1)		\
   type POLYBENCH_1D_F(POLYBENCH_DECL_VAR(var), dim1, ddim1); \
-  var = POLYBENCH_ALLOC_1D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), type);
+  var = POLYBENCH_ALLOC_1D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), type); \
+  POLYBENCH_NAME_ARRAY(var)
 #  define POLYBENCH_2D_ARRAY_DECL(var, type, dim1, dim2, ddim1, ddim2)	\
   type POLYBENCH_2D_F(POLYBENCH_DECL_VAR(var), dim1, dim2, ddim1, ddim2); \
-  var = POLYBENCH_ALLOC_2D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), POLYBENCH_C99_SELECT(dim2, ddim2), type);
+  var = POLYBENCH_ALLOC_2D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), POLYBENCH_C99_SELECT(dim2, ddim2), type); \
+  POLYBENCH_NAME_ARRAY(var)
 #  define POLYBENCH_3D_ARRAY_DECL(var, type, dim1, dim2, dim3, ddim1, ddim2, ddim3) \
   type POLYBENCH_3D_F(POLYBENCH_DECL_VAR(var), dim1, dim2, dim3, ddim1, ddim2, ddim3); \
-  var = POLYBENCH_ALLOC_3D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), POLYBENCH_C99_SELECT(dim2, ddim2), POLYBENCH_C99_SELECT(dim3, ddim3), type);
+  var = POLYBENCH_ALLOC_3D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), POLYBENCH_C99_SELECT(dim2, ddim2), POLYBENCH_C99_SELECT(dim3, ddim3), type); \
+  POLYBENCH_NAME_ARRAY(var)
 #  define POLYBENCH_4D_ARRAY_DECL(var, type, dim1, dim2, dim3, dim4, ddim1, ddim2, ddim3, ddim4) \
   type POLYBENCH_4D_F(POLYBENCH_DECL_VAR(var), dim1, dim2, dim3, dim4, ddim1, ddim2, ddim3, ddim4); \
-  var = POLYBENCH_ALLOC_4D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), POLYBENCH_C99_SELECT(dim2, ddim2), POLYBENCH_C99_SELECT(dim3, ddim3), POLYBENCH_C99_SELECT(dim4, ddim4), type);
+  var = POLYBENCH_ALLOC_4D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), POLYBENCH_C99_SELECT(dim2, ddim2), POLYBENCH_C99_SELECT(dim3, ddim3), POLYBENCH_C99_SELECT(dim4, ddim4), type); \
+  POLYBENCH_NAME_ARRAY(var)
 #  define POLYBENCH_5D_ARRAY_DECL(var, type, dim1, dim2, dim3, dim4, dim5, ddim1, ddim2, ddim3, ddim4, ddim5) \
   type POLYBENCH_5D_F(POLYBENCH_DECL_VAR(var), dim1, dim2, dim3, dim4, dim5, ddim1, ddim2, ddim3, ddim4, ddim5); \
-  var = POLYBENCH_ALLOC_5D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), POLYBENCH_C99_SELECT(dim2, ddim2), POLYBENCH_C99_SELECT(dim3, ddim3), POLYBENCH_C99_SELECT(dim4, ddim4), POLYBENCH_C99_SELECT(dim5, ddim5), type);
+  var = POLYBENCH_ALLOC_5D_ARRAY(POLYBENCH_C99_SELECT(dim1, ddim1), POLYBENCH_C99_SELECT(dim2, ddim2), POLYBENCH_C99_SELECT(dim3, ddim3), POLYBENCH_C99_SELECT(dim4, ddim4), POLYBENCH_C99_SELECT(dim5, ddim5), type); \
+  POLYBENCH_NAME_ARRAY(var)
 # else
 #  define POLYBENCH_1D_ARRAY_DECL(var, type, dim1, ddim1)		\
   type POLYBENCH_1D_F(POLYBENCH_DECL_VAR(var), dim1, ddim1);
@@ -155,7 +278,7 @@
 
 
 /* Dead-code elimination macros. Use argc/argv for the run-time check. */
-# ifndef POLYBENCH_DUMP_ARRAYS
+# if ! defined(POLYBENCH_DUMP_ARRAYS) && ! defined(POLYBENCH_CHECKSUM)
 #  define POLYBENCH_DCE_ONLY_CODE    if (argc > 42 && ! strcmp(argv[0], ""))
 # else
 #  define POLYBENCH_DCE_ONLY_CODE
@@ -171,6 +294,81 @@
   POLYBENCH_DCE_ONLY_CODE			\
   func
 
+/* Checksum mode. With POLYBENCH_CHECKSUM, print_array prints a
+   fingerprint of each live-out array, computed in parallel, instead of
+   its elements (see polybench.c), with POLYBENCH_CHECKSUM_1D or
+   POLYBENCH_CHECKSUM_2D. */
+# ifdef POLYBENCH_CHECKSUM
+#  ifndef POLYBENCH_CHECKSUM_TOLERANCE
+/* default: */
+#   define POLYBENCH_CHECKSUM_TOLERANCE 1e-6
+#  endif
+#  define POLYBENCH_CHECKSUM_1D(s, x, n)				\
+  polybench_checksum_array (s, x, 1, n, n, POLYBENCH_STRINGIFY(DATA_TYPE))
+#  define POLYBENCH_CHECKSUM_2D(s, A, n, m)				\
+  polybench_checksum_array (s, &(A)[0][0], n, m, POLYBENCH_LEADING_DIM(A), \
+			    POLYBENCH_STRINGIFY(DATA_TYPE))
+extern void polybench_checksum_array(const char* name, const void* data,
+				     long n, long m, long pitch,
+				     const char* data_type);
+# endif
+
+/* Verification mode. With POLYBENCH_VERIFY, the programs which support
+   it copy the inputs of the last run with POLYBENCH_COPY_ARRAY, run
+   the reference implementation on the copies after the timed runs, and
+   compare the results with POLYBENCH_VERIFY_1D/2D, and the solution of
+   a linear system with POLYBENCH_VERIFY_RESIDUAL (see polybench.c).
+   POLYBENCH_VERIFY_TOLERANCE, set by the header of the kernel, is in
+   machine epsilons of DATA_TYPE. main returns
+   polybench_verify_status (): 1 if a check failed, 0 otherwise. */
+# ifdef POLYBENCH_VERIFY
+#  define POLYBENCH_COPY_ARRAY(dst, src)				\
+  memcpy (POLYBENCH_ARRAY(dst), POLYBENCH_ARRAY(src),			\
+	  sizeof(POLYBENCH_ARRAY(src)))
+#  define POLYBENCH_VERIFY_1D(s, x, ref, n)				\
+  polybench_verify_array (s, x, ref, 1, n, n, n,			\
+			  POLYBENCH_STRINGIFY(DATA_TYPE),		\
+			  POLYBENCH_VERIFY_TOLERANCE)
+#  define POLYBENCH_VERIFY_2D(s, A, ref, n, m)				\
+  polybench_verify_array (s, &(A)[0][0], &(ref)[0][0], n, m,		\
+			  POLYBENCH_LEADING_DIM(A),			\
+			  POLYBENCH_LEADING_DIM(ref),			\
+			  POLYBENCH_STRINGIFY(DATA_TYPE),		\
+			  POLYBENCH_VERIFY_TOLERANCE)
+#  define POLYBENCH_VERIFY_RESIDUAL(s, A, x, b, n)			\
+  polybench_verify_residual (s, &(A)[0][0], x, b, n,			\
+			     POLYBENCH_LEADING_DIM(A),			\
+			     POLYBENCH_STRINGIFY(DATA_TYPE),		\
+			     POLYBENCH_VERIFY_TOLERANCE)
+extern int polybench_verify_array(const char* name, const void* data,
+				  const void* ref, long n, long m,
+				  long pitch, long ref_pitch,
+				  const char* data_type, double tolerance);
+extern int polybench_verify_residual(const char* name, const void* A,
+				     const void* x, const void* b, long n,
+				     long pitch, const char* data_type,
+				     double tolerance);
+extern int polybench_verify_status();
+# else
+#  define polybench_verify_status() 0
+# endif
+
+
+/* Parallel first-touch initialization. With POLYBENCH_NUMA and OpenMP,
+   polybench_parallel_init(j), placed before the outer loop of an
+   array initialization whose inner loops use the index j, distributes
+   its iterations over the threads with the static schedule of the
+   kernels. With the first-touch policy, each page is then allocated
+   on the node of the thread which later works on it. The initial
+   values do not depend on the schedule. */
+# if defined(POLYBENCH_NUMA) && defined(_OPENMP)
+#  define POLYBENCH_PRAGMA(x) _Pragma (#x)
+#  define polybench_parallel_init(priv) \
+  POLYBENCH_PRAGMA (omp parallel for schedule(static) private(priv))
+# else
+#  define polybench_parallel_init(priv)
+# endif
+
 
 /* Performance-related instrumentation. See polybench.c */
 # define polybench_start_instruments
@@ -178,6 +376,60 @@
 # define polybench_print_instruments
 
 
+/* Repeated runs. By default, the kernel is run only once. When
+   POLYBENCH_NB_RUNS > 1, the region enclosed by polybench_repeat_begin
+   and polybench_repeat_end (array initialization and timed kernel) is
+   executed POLYBENCH_NB_RUNS times, plus POLYBENCH_WARMUP_RUNS runs
+   which are not accounted for in the statistics. */
+# ifndef POLYBENCH_NB_RUNS
+/* default: */
+#  define POLYBENCH_NB_RUNS 1
+# endif
+# ifndef POLYBENCH_WARMUP_RUNS
+/* default: */
+#  define POLYBENCH_WARMUP_RUNS 0
+# endif
+# define POLYBENCH_TOTAL_NB_RUNS (POLYBENCH_NB_RUNS + POLYBENCH_WARMUP_RUNS)
+/* Maximal coefficient of variation accepted between runs, in percent. */
+# ifndef POLYBENCH_VARIANCE_THRESHOLD
+/* default: */
+#  define POLYBENCH_VARIANCE_THRESHOLD 5
+# endif
+# if POLYBENCH_NB_RUNS + POLYBENCH_WARMUP_RUNS > 1
+#  define polybench_repeat_begin					\
+  int polybench_run;							\
+  for (polybench_run = 0; polybench_run < POLYBENCH_TOTAL_NB_RUNS;	\
+       polybench_run++)							\
+    {
+#  define polybench_repeat_end			\
+    }
+# else
+#  define polybench_repeat_begin
+#  define polybench_repeat_end
+# endif
+
+
+/* Result records. With POLYBENCH_RECORD_JSON or POLYBENCH_RECORD_CSV,
+   each execution appends machine-readable records to a file (see
+   polybench.c). The kernel file, the kernel name given by its header,
+   its data type and its sizes are captured, along with the performance
+   model, where the instruments expand in the main function. */
+# if defined(POLYBENCH_RECORD_JSON) || defined(POLYBENCH_RECORD_CSV)
+#  define POLYBENCH_RECORD
+#  define polybench_record_program_info					\
+  polybench_set_program_info (__FILE__, POLYBENCH_KERNEL_NAME,		\
+			      POLYBENCH_STRINGIFY(DATA_TYPE),		\
+			      POLYBENCH_PROGRAM_SIZES, (const char*) 0);	\
+  polybench_set_program_model (POLYBENCH_PROGRAM_FLOPS,			\
+			       POLYBENCH_PROGRAM_WORDS * sizeof(DATA_TYPE));
+extern void polybench_set_program_info(const char* file,
+				       const char* kernel,
+				       const char* data_type, ...);
+# else
+#  define polybench_record_program_info
+# endif
+
+
 /* PAPI support. */
 # ifdef POLYBENCH_PAPI
 extern const unsigned int polybench_papi_eventlist[];
@@ -187,6 +439,7 @@ extern const unsigned int polybench_papi_eventlist[];
 #  define polybench_set_papi_thread_report(x)	\
    polybench_papi_counters_threadid = x;
 #  define polybench_start_instruments				\
+  polybench_record_program_info					\
   polybench_prepare_instruments();				\
   polybench_papi_init();					\
   int evid;							\
@@ -204,20 +457,56 @@ extern const unsigned int polybench_papi_eventlist[];
 # endif
 
 
+/* Linux perf_event support. All the counters are collected in a
+   single execution of the kernel. */
+# ifdef POLYBENCH_PERF
+#  undef polybench_start_instruments
+#  undef polybench_stop_instruments
+#  undef polybench_print_instruments
+#  define polybench_start_instruments		\
+  polybench_record_program_info			\
+  polybench_prepare_instruments();		\
+  polybench_perf_start();
+#  define polybench_stop_instruments polybench_perf_stop();
+#  define polybench_print_instruments		\
+  polybench_perf_print();			\
+  polybench_perf_close();
+# endif
+
+
 /* Timing support. */
 # if defined(POLYBENCH_TIME) || defined(POLYBENCH_GFLOPS)
 #  undef polybench_start_instruments
 #  undef polybench_stop_instruments
 #  undef polybench_print_instruments
-#  define polybench_start_instruments polybench_timer_start();
+#  define polybench_start_instruments				\
+  polybench_record_program_info					\
+  polybench_set_program_model (POLYBENCH_PROGRAM_FLOPS,		\
+			       POLYBENCH_PROGRAM_WORDS * sizeof(DATA_TYPE)); \
+  polybench_timer_start();
 #  define polybench_stop_instruments polybench_timer_stop();
 #  define polybench_print_instruments polybench_timer_print();
-extern double polybench_program_total_flops;
 extern void polybench_timer_start();
 extern void polybench_timer_stop();
 extern void polybench_timer_print();
 # endif
 
+
+/* Region profiling. polybench_region_begin("name") and
+   polybench_region_end("name") delimit a named region of the kernel;
+   the profile of all the regions is printed on stderr at exit. They
+   expand to nothing without POLYBENCH_REGIONS. */
+# ifdef POLYBENCH_REGIONS
+#  define polybench_region_begin(name) polybench_region_enter(name)
+#  define polybench_region_end(name) polybench_region_exit(name)
+extern void polybench_region_enter(const char* name);
+extern void polybench_region_exit(const char* name);
+extern void polybench_regions_reset();
+# else
+#  define polybench_region_begin(name)
+#  define polybench_region_end(name)
+# endif
+
 /* PAPI support. */
 # ifdef POLYBENCH_PAPI
 extern int polybench_papi_start_counter(int evid);
@@ -227,9 +516,114 @@ extern void polybench_papi_close();
 extern void polybench_papi_print();
 # endif
 
+/* perf_event support. */
+# ifdef POLYBENCH_PERF
+extern void polybench_perf_init();
+extern void polybench_perf_start();
+extern void polybench_perf_stop();
+extern void polybench_perf_close();
+extern void polybench_perf_print();
+# endif
+
+/* Performance model. Each kernel header defines POLYBENCH_PROGRAM_FLOPS
+   and POLYBENCH_PROGRAM_WORDS (see utilities/polybench.spec), which are
+   used unless the kernel sets its own values. */
+# define polybench_set_program_flops(x) polybench_program_total_flops = x;
+# define polybench_set_program_bytes(x) polybench_program_total_bytes = x;
+extern double polybench_program_total_flops;
+extern double polybench_program_total_bytes;
+extern void polybench_set_program_model(double flops, double bytes);
+
+/* With COUNT_FLOPS, kernels may count their operations in FLOP_COUNTER
+   to cross-check the analytic model. */
+# ifdef COUNT_FLOPS
+#  define FLOP_COUNTER polybench_flop_counter
+extern unsigned long long polybench_flop_counter;
+# endif
+
 /* Function prototypes. */
 extern void* polybench_alloc_data(unsigned long long int n, int elt_size);
 extern void polybench_free_data(void* ptr);
+# ifdef POLYBENCH_MEMORY_REPORT
+extern void polybench_name_data(void* ptr, const char* name);
+# endif
+
+/* Tile-major layout of 2D arrays: the array is stored as a sequence of
+   contiguous POLYBENCH_TILE_SIZE x POLYBENCH_TILE_SIZE tiles, row of
+   tiles by row of tiles, each tile in row-major order, and its
+   dimensions are rounded up to whole tiles (padded with zeros). An
+   N x M tiled array is declared with POLYBENCH_TILED_ARRAY_DECL, and
+   element (i,j) is POLYBENCH_TILED_AT(A,i,j,M). POLYBENCH_TO_TILED and
+   POLYBENCH_FROM_TILED convert from and to a POLYBENCH_2D array; they
+   are timed apart from the kernel. */
+# ifndef POLYBENCH_TILE_SIZE
+#  define POLYBENCH_TILE_SIZE 32
+# endif
+# define POLYBENCH_TILED_DIM(n) \
+  (((n) + POLYBENCH_TILE_SIZE - 1) / POLYBENCH_TILE_SIZE * POLYBENCH_TILE_SIZE)
+# define POLYBENCH_TILED_INDEX(i, j, m)					\
+  (((i) / POLYBENCH_TILE_SIZE) * POLYBENCH_TILE_SIZE * POLYBENCH_TILED_DIM(m) \
+   + ((j) / POLYBENCH_TILE_SIZE) * POLYBENCH_TILE_SIZE * POLYBENCH_TILE_SIZE \
+   + ((i) % POLYBENCH_TILE_SIZE) * POLYBENCH_TILE_SIZE + (j) % POLYBENCH_TILE_SIZE)
+# define POLYBENCH_TILED_AT(A, i, j, m) (A)[POLYBENCH_TILED_INDEX(i, j, m)]
+/* First element of the tile which contains element (i,j). */
+# define POLYBENCH_TILE_PTR(A, i, j, m)					\
+  ((A) + ((i) / POLYBENCH_TILE_SIZE) * POLYBENCH_TILE_SIZE * POLYBENCH_TILED_DIM(m) \
+   + ((j) / POLYBENCH_TILE_SIZE) * POLYBENCH_TILE_SIZE * POLYBENCH_TILE_SIZE)
+# define POLYBENCH_TILED_ARRAY_DECL(var, type, ddim1, ddim2)		\
+  type* var = (type*) polybench_alloc_data (POLYBENCH_TILED_DIM(ddim1) * POLYBENCH_TILED_DIM(ddim2), sizeof(type)); \
+  POLYBENCH_NAME_ARRAY(var)
+# define POLYBENCH_TO_TILED(T, A, n, m)					\
+  polybench_tile_2d (T, A, n, m, POLYBENCH_LEADING_DIM(A), sizeof((A)[0][0]))
+# define POLYBENCH_FROM_TILED(A, T, n, m)				\
+  polybench_untile_2d (A, T, n, m, POLYBENCH_LEADING_DIM(A), sizeof((A)[0][0]))
+extern void polybench_tile_2d(void* tiled, void* array, long n, long m,
+			      long pitch, int elt_size);
+extern void polybench_untile_2d(void* array, void* tiled, long n, long m,
+				long pitch, int elt_size);
+
+/* Scratch arena of the calling thread, for the temporaries of the
+   kernels: aligned bump allocation, released in stack order from a
+   mark (see utilities/polybench.c). */
+extern void* polybench_scratch_alloc(unsigned long size);
+extern unsigned long polybench_scratch_mark();
+extern void polybench_scratch_release(unsigned long mark);
+extern void polybench_scratch_reserve(unsigned long size);
+extern void polybench_scratch_free();
+# define polybench_scratch_reset() polybench_scratch_release (0)
+
+/* Dataset cache. With POLYBENCH_DATASET_CACHE, the arrays and scalars
+   registered with polybench_dataset_array and polybench_dataset_scalar
+   are written to a binary file once initialized, keyed by the program,
+   its sizes and DATA_TYPE; polybench_dataset_load () then maps that
+   file and copies it into them instead of running init_array:
+
+     if (! polybench_dataset_load ())
+       {
+	 init_array (...);
+	 polybench_dataset_store ();
+       }
+*/
+# ifdef POLYBENCH_DATASET_CACHE
+#  define polybench_dataset_array(x)					\
+  polybench_dataset_add (#x, POLYBENCH_ARRAY(x), sizeof(POLYBENCH_ARRAY(x)))
+#  define polybench_dataset_scalar(x)			\
+  polybench_dataset_add (#x, &(x), sizeof(x))
+#  define polybench_dataset_load()					\
+  polybench_dataset_read (__FILE__, POLYBENCH_STRINGIFY(DATA_TYPE),	\
+			  POLYBENCH_PROGRAM_SIZES, (const char*) 0)
+#  define polybench_dataset_store() polybench_dataset_write ()
+extern void polybench_dataset_add(const char* name, void* ptr,
+				  unsigned long size);
+extern int polybench_dataset_read(const char* file,
+				  const char* data_type, ...);
+extern void polybench_dataset_write();
+# else
+#  define polybench_dataset_array(x)
+#  define polybench_dataset_scalar(x)
+#  define polybench_dataset_load() 0
+#  define polybench_dataset_store()
+# endif
 
 /* PolyBench internal functions that should not be directly called by */
 /* the user, unless when designing customized execution profiling */